@@ -0,0 +1,281 @@
+/*********************************************************************
+ * @file   harness.hpp
+ * @brief  Minimal built-in benchmark harness.
+ *
+ * @details
+ * Implements the subset of Google Benchmark API used by `mywr` benchmarks
+ * (`State`, `BENCHMARK`, `DoNotOptimize`, `ClobberMemory`), so benchmarks
+ * build without any external dependency. With `MYWR_GOOGLE_BENCHMARK`
+ * defined (Google Benchmark found by CMake) includes the real library
+ * instead.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_BENCHMARK_HARNESS_HPP_
+#define MYWR_BENCHMARK_HARNESS_HPP_
+
+#if defined(MYWR_GOOGLE_BENCHMARK)
+  #include <benchmark/benchmark.h>
+#else
+  #include <chrono>
+  #include <cstdint>
+  #include <cstdio>
+  #include <functional>
+  #include <memory>
+  #include <string>
+  #include <vector>
+
+  #include "perf_counters.hpp"
+
+  #if defined(__GNUC__)
+    #define MYWR_BENCHMARK_UNUSED __attribute__((unused))
+  #else
+    #define MYWR_BENCHMARK_UNUSED
+  #endif
+
+namespace benchmark {
+/**
+ * @brief Prevents the compiler from optimizing out the value.
+ */
+template<typename T>
+inline void DoNotOptimize(T const& value) {
+#if defined(_MSC_VER)
+  const volatile void* volatile sink = &value;
+  (void)sink;
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * @brief Forces all pending memory writes to be visible to the compiler.
+ */
+inline void ClobberMemory() {
+#if defined(_MSC_VER)
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : : "memory");
+#endif
+}
+
+/**
+ * @brief State of the running benchmark. Iterating over it runs the timed
+ * loop.
+ */
+class State {
+public:
+  using clock = std::chrono::steady_clock;
+
+  State(std::vector<std::int64_t> args,
+        std::uint64_t             iterations,
+        internal::perf_counters*  counters = nullptr)
+      : m_args(std::move(args))
+      , m_iterations(iterations)
+      , m_counters(counters) {}
+
+  /**
+   * @brief Iterator of the timed loop. Starts the timer on `begin()` and
+   * stops it when the loop ends.
+   */
+  class iterator {
+  public:
+    /**
+     * @brief Value of the loop variable, never used.
+     */
+    struct MYWR_BENCHMARK_UNUSED value {};
+
+    iterator(State* state, std::uint64_t remaining)
+        : m_state(state)
+        , m_remaining(remaining) {}
+
+    bool operator!=(const iterator&) {
+      if (m_remaining != 0)
+        return true;
+
+      m_state->finish();
+      return false;
+    }
+
+    void operator++() {
+      --m_remaining;
+    }
+
+    value operator*() const {
+      return {};
+    }
+
+  private:
+    State*        m_state;
+    std::uint64_t m_remaining;
+  };
+
+  iterator begin() {
+    m_elapsed = clock::duration::zero();
+    m_started = true;
+    if (m_counters)
+      m_counters->reset();
+    ResumeTiming();
+    return {this, m_iterations};
+  }
+
+  iterator end() {
+    return {this, 0};
+  }
+
+  std::int64_t range(std::size_t index = 0) const {
+    return index < m_args.size() ? m_args[index] : 0;
+  }
+
+  std::uint64_t iterations() const {
+    return m_iterations;
+  }
+
+  void PauseTiming() {
+    m_elapsed += clock::now() - m_start;
+    if (m_counters)
+      m_counters->stop();
+  }
+
+  void ResumeTiming() {
+    if (m_counters)
+      m_counters->start();
+    m_start = clock::now();
+  }
+
+  void SetItemsProcessed(std::int64_t items) {
+    m_items = items;
+  }
+
+  void SetBytesProcessed(std::int64_t bytes) {
+    m_bytes = bytes;
+  }
+
+  void SetLabel(const std::string& label) {
+    m_label = label;
+  }
+
+  void SkipWithError(const char* message) {
+    m_error = message;
+  }
+
+  bool error_occurred() const {
+    return !m_error.empty();
+  }
+
+  /**
+   * @brief Elapsed time of the timed loop in nanoseconds.
+   */
+  double elapsed_ns() const {
+    return std::chrono::duration<double, std::nano>(m_elapsed).count();
+  }
+
+  std::int64_t items() const {
+    return m_items;
+  }
+
+  std::int64_t bytes() const {
+    return m_bytes;
+  }
+
+  const std::string& label() const {
+    return m_label;
+  }
+
+  const std::string& error() const {
+    return m_error;
+  }
+
+private:
+  void finish() {
+    if (m_started)
+      PauseTiming();
+    m_started = false;
+  }
+
+  std::vector<std::int64_t> m_args{};
+  std::uint64_t             m_iterations{};
+  internal::perf_counters*  m_counters{};
+  clock::time_point         m_start{};
+  clock::duration           m_elapsed{};
+  bool                      m_started{};
+  std::int64_t              m_items{};
+  std::int64_t              m_bytes{};
+  std::string               m_label{};
+  std::string               m_error{};
+};
+
+/**
+ * @brief Registered benchmark.
+ */
+class Benchmark {
+public:
+  using function = std::function<void(State&)>;
+
+  Benchmark(std::string name, function fn)
+      : m_name(std::move(name))
+      , m_function(std::move(fn)) {}
+
+  Benchmark* Arg(std::int64_t arg) {
+    m_args.push_back({arg});
+    return this;
+  }
+
+  Benchmark* Args(const std::vector<std::int64_t>& args) {
+    m_args.push_back(args);
+    return this;
+  }
+
+  Benchmark* Iterations(std::uint64_t iterations) {
+    m_iterations = iterations;
+    return this;
+  }
+
+  const std::string& name() const {
+    return m_name;
+  }
+
+  const function& fn() const {
+    return m_function;
+  }
+
+  const std::vector<std::vector<std::int64_t>>& args() const {
+    return m_args;
+  }
+
+  std::uint64_t iterations() const {
+    return m_iterations;
+  }
+
+private:
+  std::string                            m_name;
+  function                               m_function;
+  std::vector<std::vector<std::int64_t>> m_args{};
+  std::uint64_t                          m_iterations{};
+};
+
+namespace internal {
+inline std::vector<std::unique_ptr<Benchmark>>& registry() {
+  static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  return benchmarks;
+}
+
+inline Benchmark* RegisterBenchmarkInternal(const char*         name,
+                                            Benchmark::function fn) {
+  registry().push_back(std::make_unique<Benchmark>(name, std::move(fn)));
+  return registry().back().get();
+}
+} // namespace internal
+} // namespace benchmark
+
+  #define MYWR_BENCHMARK_CONCAT_(a, b) a##b
+  #define MYWR_BENCHMARK_CONCAT(a, b) MYWR_BENCHMARK_CONCAT_(a, b)
+
+  #define BENCHMARK(fn)                                                        \
+    static ::benchmark::Benchmark* MYWR_BENCHMARK_CONCAT(                      \
+        mywr_benchmark_, __LINE__) [[maybe_unused]] =                          \
+        ::benchmark::internal::RegisterBenchmarkInternal(#fn, fn)
+#endif
+
+#endif // !MYWR_BENCHMARK_HARNESS_HPP_
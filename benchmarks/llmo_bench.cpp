@@ -0,0 +1,378 @@
+#include "harness.hpp"
+
+#include "mywr/mywr.hpp"
+
+#if defined(MYWR_LINUX)
+namespace llmo = mywr::llmo;
+
+/**
+ * @brief Read-only executable area patched by the benchmarks.
+ */
+class code_area {
+public:
+  explicit code_area(std::size_t size)
+      : m_size(size) {
+    m_data = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                             m_size,
+                                             PROT_READ | PROT_EXEC,
+                                             MAP_PRIVATE | MAP_ANONYMOUS,
+                                             -1,
+                                             0));
+  }
+
+  ~code_area() {
+    munmap(m_data, m_size);
+  }
+
+  mywr::byte_t* data() const {
+    return m_data;
+  }
+
+private:
+  mywr::byte_t* m_data{};
+  std::size_t   m_size{};
+};
+
+static void BM_ProtectedWrite(benchmark::State& state) {
+  auto      count = static_cast<std::size_t>(state.range(0));
+  code_area code{count * sizeof(std::uint32_t)};
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < count; i++)
+      llmo::write<std::uint32_t>(code.data() + i * sizeof(std::uint32_t),
+                                 static_cast<std::uint32_t>(i));
+  }
+}
+BENCHMARK(BM_ProtectedWrite)->Arg(1)->Arg(100)->Arg(10000);
+
+static void BM_ForceWrite(benchmark::State& state) {
+  auto      count = static_cast<std::size_t>(state.range(0));
+  code_area code{count * sizeof(std::uint32_t)};
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < count; i++)
+      llmo::force_write<std::uint32_t>(
+          code.data() + i * sizeof(std::uint32_t),
+          static_cast<std::uint32_t>(i));
+  }
+}
+BENCHMARK(BM_ForceWrite)->Arg(1)->Arg(100)->Arg(10000);
+
+static void BM_ForceWriteBatch(benchmark::State& state) {
+  auto      count = static_cast<std::size_t>(state.range(0));
+  code_area code{count * sizeof(std::uint32_t)};
+
+  std::vector<std::uint32_t> values(count);
+  std::vector<llmo::patch>   patches(count);
+  for (std::size_t i = 0; i < count; i++) {
+    values[i]  = static_cast<std::uint32_t>(i);
+    patches[i] = {code.data() + i * sizeof(std::uint32_t),
+                  &values[i],
+                  sizeof(std::uint32_t)};
+  }
+
+  for (auto _ : state)
+    llmo::force_write(patches.data(), patches.size());
+}
+BENCHMARK(BM_ForceWriteBatch)->Arg(1)->Arg(100)->Arg(10000);
+
+/**
+ * @brief Common patch sizes: `int3`, `jmp rel32`, `mov r64, imm64`,
+ * `jmp [rip+0]` with its target.
+ */
+#define FIXED_SIZES(fn)                                                        \
+  (size == 1    ? fn<1>                                                        \
+   : size == 5  ? fn<5>                                                        \
+   : size == 10 ? fn<10>                                                       \
+   : size == 14 ? fn<14>                                                       \
+                : fn<16>)
+
+template<std::size_t N>
+static void fixed_copy(mywr::byte_t* dest, const mywr::byte_t* src) {
+  llmo::copy<N>(dest, src);
+}
+
+template<std::size_t N>
+static void fixed_store(mywr::byte_t* dest, const mywr::byte_t* src) {
+  llmo::impl::store_bytes<N>(dest, src, true);
+}
+
+static void BM_CopyRuntimeSize(benchmark::State& state) {
+  auto                         size = static_cast<std::size_t>(state.range(0));
+  code_area                    code{4096};
+  std::array<mywr::byte_t, 16> patch{};
+
+  for (auto _ : state)
+    llmo::copy(code.data() + 3, patch.data(), size);
+}
+BENCHMARK(BM_CopyRuntimeSize)->Arg(1)->Arg(5)->Arg(10)->Arg(14)->Arg(16);
+
+static void BM_CopyFixedSize(benchmark::State& state) {
+  auto                         size = static_cast<std::size_t>(state.range(0));
+  code_area                    code{4096};
+  std::array<mywr::byte_t, 16> patch{};
+
+  auto copy = FIXED_SIZES(fixed_copy);
+  for (auto _ : state)
+    copy(code.data() + 3, patch.data());
+}
+BENCHMARK(BM_CopyFixedSize)->Arg(1)->Arg(5)->Arg(10)->Arg(14)->Arg(16);
+
+static void BM_StoreRuntimeSize(benchmark::State& state) {
+  auto                          size = static_cast<std::size_t>(state.range(0));
+  alignas(64) mywr::byte_t      dest[64]{};
+  std::array<mywr::byte_t, 16> patch{};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(size);
+    ::memcpy(dest + 3, patch.data(), size);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_StoreRuntimeSize)->Arg(1)->Arg(5)->Arg(10)->Arg(14)->Arg(16);
+
+static void BM_StoreFixedSize(benchmark::State& state) {
+  auto                         size = static_cast<std::size_t>(state.range(0));
+  alignas(64) mywr::byte_t     dest[64]{};
+  std::array<mywr::byte_t, 16> patch{};
+
+  auto store = FIXED_SIZES(fixed_store);
+  for (auto _ : state) {
+    store(dest + 3, patch.data());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_StoreFixedSize)->Arg(1)->Arg(5)->Arg(10)->Arg(14)->Arg(16);
+
+static void BM_ReadScalars(benchmark::State& state) {
+  std::vector<std::uint32_t> array(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint32_t> out(array.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < array.size(); i++)
+      out[i] = llmo::read<std::uint32_t>(&array[i]);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_ReadScalars)->Arg(100)->Arg(10000);
+
+static void BM_ReadSpan(benchmark::State& state) {
+  std::vector<std::uint32_t> array(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint32_t> out(array.size());
+
+  for (auto _ : state) {
+    llmo::read_span(array.data(), out.data(), array.size());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_ReadSpan)->Arg(100)->Arg(10000);
+
+static void BM_Read(benchmark::State& state) {
+  std::uint32_t value = 42;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(llmo::read<std::uint32_t>(&value));
+}
+BENCHMARK(BM_Read);
+
+static void BM_Write(benchmark::State& state) {
+  code_area code{sizeof(std::uint32_t)};
+  for (auto _ : state)
+    llmo::write<std::uint32_t>(code.data(), 0x90909090);
+}
+BENCHMARK(BM_Write);
+
+static void BM_CopyBytes(benchmark::State& state) {
+  auto                      size = static_cast<std::size_t>(state.range(0));
+  code_area                 code{size};
+  std::vector<mywr::byte_t> src(size, 0x90);
+
+  for (auto _ : state)
+    llmo::copy(code.data(), src.data(), size);
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_CopyBytes)->Arg(16)->Arg(4096)->Arg(65536);
+
+static void BM_FillBytes(benchmark::State& state) {
+  auto      size = static_cast<std::size_t>(state.range(0));
+  code_area code{size};
+
+  for (auto _ : state)
+    llmo::fill(code.data(), 0x90, size);
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_FillBytes)->Arg(16)->Arg(4096)->Arg(65536);
+
+static void BM_Compare(benchmark::State& state) {
+  auto                      size = static_cast<std::size_t>(state.range(0));
+  std::vector<mywr::byte_t> buf0(size, 0x90);
+  std::vector<mywr::byte_t> buf1(size, 0x90);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(llmo::compare(buf0.data(), buf1.data(), size));
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_Compare)->Arg(16)->Arg(4096)->Arg(65536);
+
+/**
+ * @brief Three-level chain: `[[[base+0x10]+0x48]+0x8]`.
+ */
+struct chain_data {
+  std::uintptr_t root[4]{};
+  std::uintptr_t middle[16]{};
+  std::uintptr_t leaf[4]{0, 42};
+
+  chain_data() {
+    root[2]   = reinterpret_cast<std::uintptr_t>(middle);
+    middle[9] = reinterpret_cast<std::uintptr_t>(leaf);
+  }
+};
+
+static void BM_ChainScopedReads(benchmark::State& state) {
+  chain_data data;
+  for (auto _ : state) {
+    auto middle = llmo::read<std::uintptr_t>(&data.root[2]);
+    auto leaf   = llmo::read<std::uintptr_t>(middle + 0x48);
+    benchmark::DoNotOptimize(llmo::read<std::uintptr_t>(leaf + 0x8));
+  }
+}
+BENCHMARK(BM_ChainScopedReads);
+
+static void BM_ResolveChain(benchmark::State& state) {
+  chain_data     data;
+  std::uintptr_t value{};
+  for (auto _ : state) {
+    llmo::try_read(llmo::resolve_chain<0x10, 0x48, 0x8>(data.root), value);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_ResolveChain);
+
+static void BM_CachedPointerChain(benchmark::State& state) {
+  chain_data          data;
+  llmo::pointer_chain chain{data.root, {0x10, 0x48, 0x8}};
+  std::uintptr_t      value{};
+  for (auto _ : state) {
+    chain.read(value);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_CachedPointerChain);
+
+static void BM_ReadVariable(benchmark::State& state) {
+  chain_data data;
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(llmo::read<std::uintptr_t>(&data.leaf[1]));
+}
+BENCHMARK(BM_ReadVariable);
+
+static void BM_ViewLoad(benchmark::State& state) {
+  chain_data                 data;
+  llmo::view<std::uintptr_t> value{&data.leaf[1]};
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(value.load());
+}
+BENCHMARK(BM_ViewLoad);
+#endif
+
+#if defined(MYWR_FEATURE_STREAMING)
+/**
+ * @brief Area written by the fill and copy benchmarks, much bigger than the
+ * last level cache.
+ */
+constexpr std::size_t kStreamArea = 64 * 1024 * 1024;
+
+/**
+ * @brief Thread scanning its own cache-sized working set while a benchmark
+ * runs. The slower its scans, the more of its cache the benchmark evicted.
+ */
+class cache_victim {
+public:
+  cache_victim()
+      : m_data(1024 * 1024, 1) {
+    m_thread = std::thread([this] {
+      while (!m_stop.load(std::memory_order_relaxed)) {
+        auto          begin = std::chrono::steady_clock::now();
+        std::uint64_t sum{};
+        for (std::size_t i = 0; i < m_data.size(); i += 64)
+          sum += m_data[i];
+        benchmark::DoNotOptimize(sum);
+
+        m_nanoseconds += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin)
+                .count());
+        m_scans++;
+      }
+    });
+  }
+
+  /**
+   * @brief Stops the thread and returns the average duration of a scan.
+   */
+  std::string stop() {
+    m_stop = true;
+    m_thread.join();
+    return "victim " + std::to_string(m_nanoseconds / (m_scans ? m_scans : 1)) +
+           " ns/scan";
+  }
+
+private:
+  std::vector<mywr::byte_t> m_data;
+  std::thread               m_thread;
+  std::atomic<bool>         m_stop{};
+  std::uint64_t             m_nanoseconds{};
+  std::uint64_t             m_scans{};
+};
+
+/**
+ * @brief Fills or copies `kStreamArea` bytes. `state.range(0)` enables the
+ * cache victim thread.
+ */
+template <bool Copy, bool Stream>
+static void stream_benchmark(benchmark::State& state) {
+  std::vector<mywr::byte_t> dest(kStreamArea);
+  std::vector<mywr::byte_t> src(Copy ? kStreamArea : 0, 0x5A);
+
+  // Never stream or always stream.
+  std::size_t threshold = Stream ? 0 : SIZE_MAX;
+
+  std::unique_ptr<cache_victim> victim;
+  if (state.range(0) != 0)
+    victim = std::make_unique<cache_victim>();
+
+  for (auto _ : state) {
+    if constexpr (Copy)
+      mywr::llmo::stream_copy(dest.data(), src.data(), kStreamArea, threshold);
+    else
+      mywr::llmo::stream_fill(dest.data(), 0x5A, kStreamArea, threshold);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(kStreamArea));
+  if (victim)
+    state.SetLabel(victim->stop());
+}
+
+static void BM_Fill(benchmark::State& state) {
+  stream_benchmark<false, false>(state);
+}
+BENCHMARK(BM_Fill)->Arg(0)->Arg(1);
+
+static void BM_StreamFill(benchmark::State& state) {
+  stream_benchmark<false, true>(state);
+}
+BENCHMARK(BM_StreamFill)->Arg(0)->Arg(1);
+
+static void BM_Copy(benchmark::State& state) {
+  stream_benchmark<true, false>(state);
+}
+BENCHMARK(BM_Copy)->Arg(0)->Arg(1);
+
+static void BM_StreamCopy(benchmark::State& state) {
+  stream_benchmark<true, true>(state);
+}
+BENCHMARK(BM_StreamCopy)->Arg(0)->Arg(1);
+#endif
@@ -0,0 +1,256 @@
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+
+#include "harness.hpp"
+
+#include "mywr/mywr.hpp"
+
+namespace {
+/**
+ * @brief Measurements of one benchmark instance.
+ */
+struct result {
+  std::string   name;
+  std::uint64_t iterations{};
+  double        ns_per_iteration{};
+  double        bytes_per_second{};
+  double        items_per_second{};
+  std::string   label;
+  std::string   error;
+
+  /**
+   * @brief Hardware counters per iteration.
+   */
+  std::vector<benchmark::internal::perf_counters::value> counters;
+};
+
+/**
+ * @brief Runs one benchmark instance, growing the number of iterations until
+ * the run takes at least `min_time_ns`.
+ */
+result run(const benchmark::Benchmark&         bench,
+           const std::vector<std::int64_t>&    args,
+           double                              min_time_ns,
+           benchmark::internal::perf_counters& counters) {
+  result measured{};
+  measured.name = bench.name();
+  for (auto arg : args)
+    measured.name += "/" + std::to_string(arg);
+
+  std::uint64_t iterations = bench.iterations() ? bench.iterations() : 1;
+  for (;;) {
+    benchmark::State state{
+        args, iterations, counters.active() ? &counters : nullptr};
+    bench.fn()(state);
+
+    if (!state.error().empty()) {
+      measured.error = state.error();
+      return measured;
+    }
+
+    double elapsed = state.elapsed_ns();
+    if (bench.iterations() || elapsed >= min_time_ns ||
+        iterations >= (1ull << 40)) {
+      double seconds = elapsed > 0 ? elapsed / 1e9 : 1e-9;
+
+      measured.iterations       = iterations;
+      measured.ns_per_iteration = elapsed / static_cast<double>(iterations);
+      measured.bytes_per_second = static_cast<double>(state.bytes()) / seconds;
+      measured.items_per_second = static_cast<double>(state.items()) / seconds;
+      measured.label            = state.label();
+      measured.counters         = counters.read(iterations);
+      return measured;
+    }
+
+    /**
+     * Predict the number of iterations needed, but grow at most 10 times.
+     */
+    double scale = elapsed > 0 ? min_time_ns * 1.4 / elapsed : 10.0;
+    scale        = scale > 10.0 ? 10.0 : (scale < 2.0 ? 2.0 : scale);
+    iterations   = static_cast<std::uint64_t>(iterations * scale);
+  }
+}
+
+/**
+ * @brief Prints the result as a console line.
+ */
+void print_console(std::FILE* out, const result& measured) {
+  const char* name = measured.name.c_str();
+  if (!measured.error.empty()) {
+    std::fprintf(out, "%-48s ERROR: %s\n", name, measured.error.c_str());
+    return;
+  }
+
+  std::fprintf(out,
+               "%-48s %14.1f ns/op %12llu it",
+               name,
+               measured.ns_per_iteration,
+               static_cast<unsigned long long>(measured.iterations));
+
+  if (measured.bytes_per_second != 0)
+    std::fprintf(
+        out, " %10.1f MiB/s", measured.bytes_per_second / (1024.0 * 1024.0));
+  if (measured.items_per_second != 0)
+    std::fprintf(out, " %12.1f items/s", measured.items_per_second);
+  if (!measured.label.empty())
+    std::fprintf(out, " %s", measured.label.c_str());
+  for (const auto& [name, value] : measured.counters)
+    std::fprintf(out, " %s=%.2f", name.c_str(), value);
+
+  std::fprintf(out, "\n");
+}
+
+/**
+ * @brief Returns the string as a JSON string literal.
+ */
+std::string quote(const std::string& text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+/**
+ * @brief Prints the results in the JSON format of Google Benchmark, so both
+ * harnesses feed the same comparison tools.
+ */
+void print_json(std::FILE*                 out,
+                const std::vector<result>& results,
+                const char*                executable) {
+  char        date[64]{};
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  std::fprintf(out, "{\n  \"context\": {\n");
+  std::fprintf(out, "    \"date\": %s,\n", quote(date).c_str());
+  std::fprintf(out, "    \"executable\": %s,\n", quote(executable).c_str());
+  std::fprintf(out,
+               "    \"num_cpus\": %u,\n",
+               std::thread::hardware_concurrency());
+  std::fprintf(out, "    \"mywr_version\": \"%s\",\n", MYWR_VERSION_STR);
+  std::fprintf(out, "    \"library_build_type\": \"built-in harness\"\n");
+  std::fprintf(out, "  },\n  \"benchmarks\": [");
+
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const result& measured = results[i];
+
+    std::fprintf(out, "%s\n    {\n", i ? "," : "");
+    std::string name = quote(measured.name);
+    std::fprintf(out, "      \"name\": %s,\n", name.c_str());
+    std::fprintf(out, "      \"run_name\": %s,\n", name.c_str());
+    std::fprintf(out, "      \"run_type\": \"iteration\",\n");
+    if (!measured.error.empty()) {
+      std::fprintf(out, "      \"error_occurred\": true,\n");
+      std::fprintf(out,
+                   "      \"error_message\": %s\n    }",
+                   quote(measured.error).c_str());
+      continue;
+    }
+
+    std::fprintf(out,
+                 "      \"iterations\": %llu,\n",
+                 static_cast<unsigned long long>(measured.iterations));
+    double time = measured.ns_per_iteration;
+    std::fprintf(out, "      \"real_time\": %.4f,\n", time);
+    std::fprintf(out, "      \"cpu_time\": %.4f,\n", time);
+    std::fprintf(out, "      \"time_unit\": \"ns\"");
+    if (measured.bytes_per_second != 0)
+      std::fprintf(out,
+                   ",\n      \"bytes_per_second\": %.4f",
+                   measured.bytes_per_second);
+    if (measured.items_per_second != 0)
+      std::fprintf(out,
+                   ",\n      \"items_per_second\": %.4f",
+                   measured.items_per_second);
+    if (!measured.label.empty())
+      std::fprintf(
+          out, ",\n      \"label\": %s", quote(measured.label).c_str());
+    for (const auto& [name, value] : measured.counters)
+      std::fprintf(out, ",\n      %s: %.4f", quote(name).c_str(), value);
+    std::fprintf(out, "\n    }");
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* filter      = nullptr;
+  const char* out_path    = nullptr;
+  const char* events      = nullptr;
+  bool        json        = false;
+  bool        out_json    = true;
+  double      min_time_ns = 0.2e9;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--benchmark_filter=", 19) == 0)
+      filter = argv[i] + 19;
+    else if (std::strncmp(argv[i], "--benchmark_min_time=", 21) == 0)
+      min_time_ns = std::atof(argv[i] + 21) * 1e9;
+    else if (std::strncmp(argv[i], "--benchmark_format=", 19) == 0)
+      json = std::strcmp(argv[i] + 19, "json") == 0;
+    else if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0)
+      out_path = argv[i] + 16;
+    else if (std::strncmp(argv[i], "--benchmark_out_format=", 23) == 0)
+      out_json = std::strcmp(argv[i] + 23, "json") == 0;
+    else if (std::strncmp(argv[i], "--benchmark_perf_counters=", 26) == 0)
+      events = argv[i] + 26;
+  }
+
+  // Benchmarks still run without counters if perf is restricted.
+  benchmark::internal::perf_counters counters;
+  if (events) {
+    std::string reason = counters.open(events);
+    if (!reason.empty())
+      std::fprintf(stderr, "perf counters are disabled: %s\n", reason.c_str());
+  }
+
+  std::vector<result> results;
+  for (const auto& bench : benchmark::internal::registry()) {
+    if (filter && bench->name().find(filter) == std::string::npos)
+      continue;
+
+    auto instances = bench->args();
+    if (instances.empty())
+      instances.emplace_back();
+
+    for (const auto& args : instances) {
+      results.push_back(run(*bench, args, min_time_ns, counters));
+      if (!json) {
+        print_console(stdout, results.back());
+        std::fflush(stdout);
+      }
+    }
+  }
+
+  if (json)
+    print_json(stdout, results, argv[0]);
+
+  if (out_path) {
+    std::FILE* out = std::fopen(out_path, "w");
+    if (!out) {
+      std::fprintf(stderr, "failed to open %s\n", out_path);
+      return 1;
+    }
+
+    if (out_json) {
+      print_json(out, results, argv[0]);
+    } else {
+      for (const auto& measured : results)
+        print_console(out, measured);
+    }
+    std::fclose(out);
+  }
+  return 0;
+}
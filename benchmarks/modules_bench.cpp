@@ -0,0 +1,45 @@
+#include "harness.hpp"
+
+#include "mywr/mywr.hpp"
+
+#if defined(MYWR_LINUX)
+namespace modules = mywr::modules;
+
+/**
+ * @brief Table of known offsets in the main executable and the C library.
+ */
+static std::vector<mywr::module_address> make_table(std::size_t count) {
+  std::vector<mywr::module_address> table;
+  for (std::size_t i = 0; i < count; i++)
+    table.emplace_back(i % 2 ? "" : "libc.so.6", i * 0x10);
+  return table;
+}
+
+static void BM_ResolvePerEntry(benchmark::State& state) {
+  auto table = make_table(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    for (auto& entry : table) {
+      std::string_view name = entry.module();
+      mywr::address_t  base{};
+      modules::impl::find_bases(&name, &base, 1);
+      benchmark::DoNotOptimize(base + entry.rva());
+    }
+  }
+}
+BENCHMARK(BM_ResolvePerEntry)->Arg(10)->Arg(1000);
+
+static void BM_ResolveAll(benchmark::State& state) {
+  auto table = make_table(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    modules::flush_cache();
+    table = make_table(table.size());
+    state.ResumeTiming();
+
+    mywr::module_address::resolve_all(table.data(), table.size());
+  }
+}
+BENCHMARK(BM_ResolveAll)->Arg(10)->Arg(1000);
+#endif
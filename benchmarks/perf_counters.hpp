@@ -0,0 +1,286 @@
+/*********************************************************************
+ * @file   perf_counters.hpp
+ * @brief  Hardware performance counters of the built-in benchmark harness.
+ *
+ * @details
+ * Counts events of the benchmarking thread by `perf_event_open` while the
+ * timed loop runs. Every event is opened on its own, so events missing on
+ * the CPU (virtual machines often lack cache and TLB events) or forbidden by
+ * `perf_event_paranoid` are skipped and the rest are still reported. When
+ * more events are open than the CPU has counters, the kernel multiplexes them
+ * and the values are scaled by the time they were actually counted.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_BENCHMARK_PERF_COUNTERS_HPP_
+#define MYWR_BENCHMARK_PERF_COUNTERS_HPP_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace benchmark {
+namespace internal {
+/**
+ * @brief Set of counted events.
+ */
+class perf_counters {
+public:
+  /**
+   * @brief Value of the event, per iteration when reported.
+   */
+  using value = std::pair<std::string, double>;
+
+  perf_counters() = default;
+
+  ~perf_counters() {
+    close();
+  }
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  perf_counters(const perf_counters&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const perf_counters&) = delete;
+
+  /**
+   * @brief Opens the events.
+   *
+   * @param[in] names Comma-separated event names, `all` for every known one.
+   *
+   * @return Empty string if at least one event was opened, the reason why
+   * nothing is counted otherwise.
+   */
+  std::string open(const std::string& names) {
+    close();
+
+#if defined(__linux__)
+    int error = 0;
+    for (const auto& known : events()) {
+      if (names != "all" && !listed(names, known.name))
+        continue;
+
+      int fd = open_event(known);
+      if (fd < 0) {
+        error = errno;
+        continue;
+      }
+      m_events.push_back({known.name, fd});
+    }
+
+    if (!m_events.empty())
+      return {};
+    if (error == 0)
+      return "no known events requested";
+
+    std::string reason = "perf_event_open: ";
+    reason += std::strerror(error);
+    if (error == EACCES || error == EPERM)
+      reason += ", see /proc/sys/kernel/perf_event_paranoid";
+    return reason;
+#else
+    static_cast<void>(names);
+    return "perf_event_open is available only on Linux";
+#endif
+  }
+
+  /**
+   * @brief Returns `true` if any event is counted.
+   */
+  bool active() const {
+    return !m_events.empty();
+  }
+
+  /**
+   * @brief Zeroes the events.
+   */
+  void reset() {
+#if defined(__linux__)
+    control(PERF_EVENT_IOC_RESET);
+#endif
+  }
+
+  /**
+   * @brief Starts counting.
+   */
+  void start() {
+#if defined(__linux__)
+    control(PERF_EVENT_IOC_ENABLE);
+#endif
+  }
+
+  /**
+   * @brief Stops counting.
+   */
+  void stop() {
+#if defined(__linux__)
+    control(PERF_EVENT_IOC_DISABLE);
+#endif
+  }
+
+  /**
+   * @brief Returns the values counted since @ref reset, divided by the
+   * number of iterations.
+   */
+  std::vector<value> read(std::uint64_t iterations) const {
+    std::vector<value> values;
+#if defined(__linux__)
+    for (const auto& opened : m_events) {
+      // The value and the times the event was enabled and counted.
+      std::uint64_t data[3]{};
+      if (::read(opened.fd, data, sizeof(data)) != sizeof(data))
+        continue;
+
+      double count = static_cast<double>(data[0]);
+      if (data[2] != 0 && data[2] < data[1])
+        count *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+
+      double per_iteration = iterations ? static_cast<double>(iterations) : 1;
+      values.push_back({opened.name, count / per_iteration});
+    }
+#else
+    static_cast<void>(iterations);
+#endif
+    return values;
+  }
+
+private:
+  /**
+   * @brief Known event.
+   */
+  struct event {
+    const char*   name;
+    std::uint32_t type;
+    std::uint64_t config;
+  };
+
+  /**
+   * @brief Opened event.
+   */
+  struct opened_event {
+    std::string name;
+    int         fd;
+  };
+
+#if defined(__linux__)
+  /**
+   * @brief Returns the config of the cache event counting read misses.
+   */
+  static constexpr std::uint64_t cache_miss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+
+  /**
+   * @brief Returns the known events, named as by `perf stat`.
+   */
+  static const std::vector<event>& events() {
+    static const std::vector<event> known{
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {"L1-dcache-load-misses",
+         PERF_TYPE_HW_CACHE,
+         cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+        {"LLC-load-misses",
+         PERF_TYPE_HW_CACHE,
+         cache_miss(PERF_COUNT_HW_CACHE_LL)},
+        {"dTLB-load-misses",
+         PERF_TYPE_HW_CACHE,
+         cache_miss(PERF_COUNT_HW_CACHE_DTLB)},
+        {"iTLB-load-misses",
+         PERF_TYPE_HW_CACHE,
+         cache_miss(PERF_COUNT_HW_CACHE_ITLB)},
+        {"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+    return known;
+  }
+
+  /**
+   * @brief Opens the disabled event of the calling thread. Counts the kernel
+   * too if `perf_event_paranoid` allows it, user space only otherwise.
+   *
+   * @return The descriptor or -1.
+   */
+  static int open_event(const event& known) {
+    perf_event_attr attr{};
+    attr.size        = sizeof(attr);
+    attr.type        = known.type;
+    attr.config      = known.config;
+    attr.disabled    = 1;
+    attr.exclude_hv  = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    for (int exclude_kernel = 0; exclude_kernel < 2; exclude_kernel++) {
+      attr.exclude_kernel = static_cast<std::uint64_t>(exclude_kernel);
+
+      long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fd >= 0)
+        return static_cast<int>(fd);
+      if (errno != EACCES && errno != EPERM)
+        break;
+    }
+    return -1;
+  }
+#endif
+
+  /**
+   * @brief Returns `true` if the name is in the comma-separated list.
+   */
+  static bool listed(const std::string& names, const char* name) {
+    std::size_t begin = 0;
+    while (begin <= names.size()) {
+      std::size_t end = names.find(',', begin);
+      if (end == std::string::npos)
+        end = names.size();
+      if (names.compare(begin, end - begin, name) == 0)
+        return true;
+      begin = end + 1;
+    }
+    return false;
+  }
+
+#if defined(__linux__)
+  /**
+   * @brief Applies the control operation to all events.
+   */
+  void control(unsigned long operation) {
+    for (const auto& opened : m_events)
+      ioctl(opened.fd, operation, 0);
+  }
+#endif
+
+  /**
+   * @brief Closes the events.
+   */
+  void close() {
+#if defined(__linux__)
+    for (const auto& opened : m_events)
+      ::close(opened.fd);
+#endif
+    m_events.clear();
+  }
+
+  std::vector<opened_event> m_events{};
+};
+} // namespace internal
+} // namespace benchmark
+
+#endif // !MYWR_BENCHMARK_PERF_COUNTERS_HPP_
@@ -0,0 +1,148 @@
+#include "harness.hpp"
+
+#include "mywr/mywr.hpp"
+
+#include "address_space.hpp"
+
+#if defined(MYWR_LINUX)
+using namespace mywr::procfs;
+
+/**
+ * @brief Creates `state.range(0)` extra regions and labels the benchmark with
+ * the total number of regions.
+ */
+static bool add_regions(benchmark::State&                   state,
+                        const mywr_test::synthetic_address_space& space) {
+  if (!space.good()) {
+    state.SkipWithError("failed to map the regions");
+    return false;
+  }
+
+  std::size_t regions = 0;
+  for_each_region([&regions](const memory_region&) {
+    ++regions;
+  });
+  state.SetLabel(std::to_string(regions) + " regions" +
+                 (space.named() ? ", named" : ""));
+  return true;
+}
+
+/**
+ * @brief Returns the number of regions to add or skips the benchmark if
+ * `vm.max_map_count` doesn't allow that many.
+ */
+static std::size_t requested_regions(benchmark::State& state) {
+  auto regions = static_cast<std::size_t>(state.range(0));
+  if (regions > mywr_test::available_mappings()) {
+    state.SkipWithError("vm.max_map_count is too low");
+    return 0;
+  }
+  return regions;
+}
+
+static void BM_QueryRegionProcmap(benchmark::State& state) {
+  if (!procmap_query_available()) {
+    state.SkipWithError("PROCMAP_QUERY is not supported by the kernel");
+    return;
+  }
+
+  int           local = 0;
+  memory_region region{};
+  for (auto _ : state) {
+    query_region(reinterpret_cast<std::uintptr_t>(&local), region);
+    benchmark::DoNotOptimize(region);
+  }
+}
+BENCHMARK(BM_QueryRegionProcmap);
+
+static void BM_QueryRegionFullParse(benchmark::State& state) {
+  int           local = 0;
+  memory_region region{};
+  for (auto _ : state) {
+    find_region(reinterpret_cast<std::uintptr_t>(&local), region);
+    benchmark::DoNotOptimize(region);
+  }
+}
+BENCHMARK(BM_QueryRegionFullParse);
+
+static void BM_QueryRegion(benchmark::State& state) {
+  mywr_test::synthetic_address_space space{requested_regions(state)};
+  if (state.error_occurred() || !add_regions(state, space))
+    return;
+
+  // The middle of the added regions, or the stack without them.
+  int            local   = 0;
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(&local);
+  if (space.regions() != 0)
+    address = reinterpret_cast<std::uintptr_t>(
+        space.region(space.regions() / 2));
+
+  memory_region region{};
+  for (auto _ : state) {
+    query_region(address, region);
+    benchmark::DoNotOptimize(region);
+  }
+}
+BENCHMARK(BM_QueryRegion)->Arg(0)->Arg(1000)->Arg(10000)->Arg(50000);
+
+static void BM_GetProtect(benchmark::State& state) {
+  mywr_test::synthetic_address_space space{requested_regions(state)};
+  if (state.error_occurred() || !add_regions(state, space))
+    return;
+
+  int local = 0;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(mywr::protect::get_protect(&local));
+}
+BENCHMARK(BM_GetProtect)->Arg(0)->Arg(1000)->Arg(10000)->Arg(50000);
+
+static void BM_ForEachRegion(benchmark::State& state) {
+  mywr_test::synthetic_address_space space{requested_regions(state)};
+  if (state.error_occurred() || !add_regions(state, space))
+    return;
+
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for_each_region([&count](const memory_region&) {
+      ++count;
+    });
+    benchmark::DoNotOptimize(count);
+  }
+}
+BENCHMARK(BM_ForEachRegion)->Arg(0)->Arg(1000)->Arg(10000)->Arg(50000);
+
+static void BM_ParseMaps(benchmark::State& state) {
+  mywr_test::synthetic_address_space space{requested_regions(state)};
+  if (state.error_occurred() || !add_regions(state, space))
+    return;
+
+  std::vector<memory_region> regions;
+  for (auto _ : state) {
+    regions.clear();
+    parse_maps(regions);
+    benchmark::DoNotOptimize(regions.data());
+  }
+}
+BENCHMARK(BM_ParseMaps)->Arg(0)->Arg(1000)->Arg(10000)->Arg(50000);
+
+static void BM_ParseRecordedMaps(benchmark::State& state) {
+  std::string maps = mywr_test::scale_maps(
+      mywr_test::load_maps("server.maps"),
+      static_cast<std::size_t>(state.range(0)));
+  if (maps.empty()) {
+    state.SkipWithError("failed to load tests/data/maps/server.maps");
+    return;
+  }
+
+  std::vector<memory_region> regions;
+  for (auto _ : state) {
+    regions.clear();
+    parser parser{maps.data(), maps.size()};
+    parse_maps(parser, regions);
+    benchmark::DoNotOptimize(regions.data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(maps.size()));
+}
+BENCHMARK(BM_ParseRecordedMaps)->Arg(1000)->Arg(10000)->Arg(50000);
+#endif
@@ -0,0 +1,94 @@
+#include "harness.hpp"
+
+#include "mywr/mywr.hpp"
+
+#if defined(MYWR_LINUX)
+namespace protect = mywr::protect;
+
+/**
+ * @brief Page of code-like memory for toggling benchmarks.
+ */
+class page {
+public:
+  page() {
+    m_size = mywr::page_size();
+    m_data = mmap(nullptr,
+                  m_size,
+                  PROT_READ | PROT_EXEC,
+                  MAP_PRIVATE | MAP_ANONYMOUS,
+                  -1,
+                  0);
+  }
+
+  ~page() {
+    munmap(m_data, m_size);
+  }
+
+  void* data() const {
+    return m_data;
+  }
+
+  std::size_t size() const {
+    return m_size;
+  }
+
+private:
+  void*       m_data{};
+  std::size_t m_size{};
+};
+
+static void BM_PkeyDomainToggle(benchmark::State& state) {
+  page                 code;
+  protect::pkey_domain domain{
+      static_cast<protect::pkey_domain::backend_type>(state.range(0))};
+
+  if (state.range(0) == protect::pkey_domain::kPkey &&
+      domain.backend() != protect::pkey_domain::kPkey) {
+    state.SkipWithError("protection keys are not supported");
+    return;
+  }
+
+  domain.tag(code.data(), code.size());
+  for (auto _ : state) {
+    domain.enable_write();
+    domain.disable_write();
+  }
+}
+BENCHMARK(BM_PkeyDomainToggle)
+    ->Arg(protect::pkey_domain::kPkey)
+    ->Arg(protect::pkey_domain::kMprotect);
+
+static void BM_RawMprotectToggle(benchmark::State& state) {
+  page code;
+  for (auto _ : state) {
+    mprotect(code.data(), code.size(), PROT_READ | PROT_WRITE | PROT_EXEC);
+    mprotect(code.data(), code.size(), PROT_READ | PROT_EXEC);
+  }
+}
+BENCHMARK(BM_RawMprotectToggle);
+
+static void BM_SetProtect(benchmark::State& state) {
+  page code;
+  for (auto _ : state) {
+    protect::set_protect(
+        code.data(), code.size(), protect::memory_prot::kExecuteReadWrite);
+    protect::set_protect(
+        code.data(), code.size(), protect::memory_prot::kExecuteRead);
+  }
+}
+BENCHMARK(BM_SetProtect);
+
+static void BM_ScopedProtect(benchmark::State& state) {
+  page code;
+  protect::set_deferred_restore(state.range(0) != 0);
+
+  for (auto _ : state) {
+    protect::scoped_protect scope{
+        code.data(), 1, protect::memory_prot::kExecuteReadWrite};
+    benchmark::DoNotOptimize(scope.good());
+  }
+
+  protect::set_deferred_restore(false);
+}
+BENCHMARK(BM_ScopedProtect)->Arg(0)->Arg(1);
+#endif
@@ -0,0 +1,61 @@
+#include "harness.hpp"
+
+#include "mywr/mywr.hpp"
+
+namespace scan = mywr::scan;
+
+/**
+ * @brief Memory walked by the benchmarks, much bigger than the last level
+ * cache.
+ */
+constexpr std::size_t kScanArea = 256 * 1024 * 1024;
+
+/**
+ * @brief Sums 8-byte words of the chunk, the cheapest scan possible.
+ */
+static std::uint64_t sum_words(const mywr::byte_t* data, std::size_t size) {
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    sum += word;
+  }
+  return sum;
+}
+
+static void BM_ScanLoop(benchmark::State& state) {
+  std::vector<mywr::byte_t> area(kScanArea, 1);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(sum_words(area.data(), area.size()));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(kScanArea));
+}
+BENCHMARK(BM_ScanLoop);
+
+/**
+ * @brief `state.range(0)` is the prefetch distance in KiB.
+ */
+static void BM_ScanWalk(benchmark::State& state) {
+  std::vector<mywr::byte_t> area(kScanArea, 1);
+
+  scan::walk_options options;
+  options.prefetch_distance = static_cast<std::size_t>(state.range(0)) * 1024;
+
+  auto range = mywr::address_range::from_size(area.data(), area.size());
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    scan::walk(
+        range,
+        [&](const scan::chunk& chunk) {
+          sum += sum_words(chunk.data, chunk.size);
+        },
+        options);
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(kScanArea));
+}
+BENCHMARK(BM_ScanWalk)->Arg(0)->Arg(16)->Arg(64)->Arg(256);
@@ -52,12 +52,15 @@ constexpr auto MYWR_VERSION_STR = "1.33.1";
 #if defined(MYWR_MSVC)
   #define MYWR_INLINE inline
   #define MYWR_FORCEINLINE __forceinline
+  #define MYWR_TARGET(isa)
 #elif defined(MYWR_GCC)
   #define MYWR_INLINE inline __attribute__((always_inline))
   #define MYWR_FORCEINLINE MYWR_INLINE
+  #define MYWR_TARGET(isa) __attribute__((target(isa)))
 #else
   #define MYWR_INLINE inline
   #define MYWR_FORCEINLINE MYWR_INLINE
+  #define MYWR_TARGET(isa)
 #endif
 
 #if defined(__has_include)
@@ -102,9 +105,52 @@ constexpr auto MYWR_VERSION_STR = "1.33.1";
   #else
     #define MYWR_FEATURE_NO_MPROTECT
   #endif
+
+  #include <unistd.h>
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <poll.h>
+  #include <pthread.h>
+
+  #if defined(MYWR_LINUX)
+    #include <sys/syscall.h>
+    #include <sys/ioctl.h>
+    #include <sys/eventfd.h>
+    #include <sys/uio.h>
+
+    #if MYWR_HAS_INCLUDE(<linux/userfaultfd.h>)
+      #include <linux/userfaultfd.h>
+    #else
+      #define MYWR_FEATURE_NO_USERFAULTFD
+    #endif
+  #endif
   // clang-format on
 #endif
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(MYWR_X86)) &&          \
+    MYWR_HAS_INCLUDE(<immintrin.h>)
+  #include <immintrin.h>
+  #if defined(MYWR_MSVC)
+    #include <intrin.h>
+  #endif
+
+  #define MYWR_FEATURE_STREAMING
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||            \
+    defined(_M_IX86)
+  #if defined(MYWR_MSVC)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+
+  #define MYWR_FEATURE_RDTSC
+#endif
+
+#include <cstdint>
+#include <cstddef>
+
 /**
  * @brief The core namespace of the `memwrapper` library.
  */
@@ -128,21 +174,36 @@ using address_t = std::uint64_t;
 #include <type_traits>
 #include <map>
 #include <tuple>
+#include <array>
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <string_view>
 #include <filesystem>
 #include <fstream>
 #include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
 
 /// Internal Libraries.
 #include "x86_64/address.hpp"
+#include "x86_64/stats.hpp"
+#include "x86_64/trace.hpp"
 #include "x86_64/procfs.hpp"
+#include "x86_64/modules.hpp"
+#include "x86_64/scan.hpp"
 #include "x86_64/detail.hpp"
 #include "x86_64/traits.hpp"
 #include "x86_64/protect.hpp"
 #include "x86_64/llmo.hpp"
+#include "x86_64/arena.hpp"
 #include "x86_64/invoker.hpp"
 #include "x86_64/disassembler.hpp"
+#include "x86_64/watch.hpp"
 
 #endif // !MYWR_HPP_
@@ -9,6 +9,15 @@ namespace mywr {
  * A utility class that converts all pointers to addresses. It is needed
  * primarily for mathematical operations with pointers, which need to be
  * converted into integrals without this class.
+ *
+ * Everything except conversions from and to pointers is `constexpr`, so
+ * tables of known addresses can be built at compile time.
+ *
+ * @code{.cpp}
+ * constexpr mywr::address kBase{0x400000};
+ * constexpr mywr::address kHealth = kBase + 0x1234;
+ * static_assert(kHealth.value() == 0x401234);
+ * @endcode
  */
 class address {
 public:
@@ -55,7 +64,7 @@ public:
    * @endcode
    */
   template<class T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
-  address(T value)
+  constexpr address(T value)
       : m_address(value) {}
 
   /**
@@ -101,7 +110,7 @@ public:
    * @par Parameters
    *  None.
    */
-  MYWR_INLINE const address_t value() const {
+  MYWR_INLINE constexpr const address_t value() const {
     return m_address;
   }
 
@@ -118,7 +127,7 @@ public:
    * @brief Returns the address of the passed value.
    * @see address::value()
    */
-  MYWR_INLINE operator address_t() const {
+  MYWR_INLINE constexpr operator address_t() const {
     return m_address;
   }
 
@@ -139,42 +148,42 @@ public:
   /**
    * @brief Returns an address based on the sum between the other two.
    */
-  MYWR_INLINE address operator+(const address& rhs) const {
+  MYWR_INLINE constexpr address operator+(const address& rhs) const {
     return value() + rhs.value();
   }
 
   /**
    * @brief Returns an address based on the difference between the other two.
    */
-  MYWR_INLINE address operator-(const address& rhs) const {
+  MYWR_INLINE constexpr address operator-(const address& rhs) const {
     return value() - rhs.value();
   }
 
   /**
    * @brief Adds the value of the passed one to the current address.
    */
-  MYWR_INLINE void operator+=(const address& rhs) {
+  MYWR_INLINE constexpr void operator+=(const address& rhs) {
     m_address += rhs.value();
   }
 
   /**
    * @brief Reduces the value of the passed address for the current address.
    */
-  MYWR_INLINE void operator-=(const address& rhs) {
+  MYWR_INLINE constexpr void operator-=(const address& rhs) {
     m_address -= rhs.value();
   }
 
   /**
    * @brief Compares two addresses for equality.
    */
-  MYWR_INLINE bool operator==(const address& rhs) const {
+  MYWR_INLINE constexpr bool operator==(const address& rhs) const {
     return value() == rhs.value();
   }
 
   /**
    * @brief Compares two addresses for inequality.
    */
-  MYWR_INLINE bool operator!=(const address& rhs) const {
+  MYWR_INLINE constexpr bool operator!=(const address& rhs) const {
     return value() != rhs.value();
   }
   /**
@@ -190,12 +199,313 @@ private:
   /**
    * @brief The value of the integral or the address of the passed pointer.
    */
-  address_t m_address;
+  address_t m_address{};
 
   /**
    * @}.
    */
 };
+
+/**
+ * @brief Returns the size of the memory page. Queried once.
+ */
+MYWR_INLINE std::size_t page_size() {
+#if defined(MYWR_WINDOWS)
+  static const std::size_t size = [] {
+    SYSTEM_INFO info{};
+    GetSystemInfo(&info);
+    return static_cast<std::size_t>(info.dwPageSize);
+  }();
+#else
+  static const std::size_t size =
+      static_cast<std::size_t>(sysconf(_SC_PAGE_SIZE));
+#endif
+  return size;
+}
+
+/**
+ * @brief Returns the size of the huge page (the transparent huge page on
+ * Linux, the large page on Windows), zero if they are not supported. Queried
+ * once.
+ */
+inline std::size_t huge_page_size() {
+#if defined(MYWR_WINDOWS)
+  static const std::size_t size =
+      static_cast<std::size_t>(GetLargePageMinimum());
+#elif defined(MYWR_LINUX)
+  static const std::size_t size = [] {
+    int fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+                  O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return std::size_t{0};
+
+    char    buffer[32]{};
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+
+    std::size_t value = 0;
+    for (ssize_t i = 0; i < length && buffer[i] >= '0' && buffer[i] <= '9';
+         i++)
+      value = value * 10 + static_cast<std::size_t>(buffer[i] - '0');
+    return value;
+  }();
+#else
+  static const std::size_t size = 0;
+#endif
+  return size;
+}
+
+/**
+ * @class address_range
+ * @brief Half-open range of addresses `[begin, end)`.
+ *
+ * @details
+ * Keeps the range math of protection and memory modules in one place:
+ * alignment to pages, intersections and page iteration.
+ *
+ * @code{.cpp}
+ * auto area = mywr::address_range::from_size(0xDEADBEEF, 4).page_aligned();
+ * for (mywr::address_t page : area.pages())
+ *   touch(page);
+ * @endcode
+ */
+class address_range {
+public:
+  /**
+   * @brief Iterator over pages of the range.
+   */
+  class page_iterator {
+  public:
+    constexpr page_iterator(address_t page, std::size_t step)
+        : m_page(page)
+        , m_step(step) {}
+
+    MYWR_INLINE constexpr address_t operator*() const {
+      return m_page;
+    }
+
+    MYWR_INLINE constexpr page_iterator& operator++() {
+      m_page += static_cast<address_t>(m_step);
+      return *this;
+    }
+
+    MYWR_INLINE constexpr bool operator!=(const page_iterator& rhs) const {
+      return m_page != rhs.m_page;
+    }
+
+  private:
+    address_t   m_page;
+    std::size_t m_step;
+  };
+
+  /**
+   * @brief Pages of the range, see @ref pages.
+   */
+  class page_list {
+  public:
+    constexpr page_list(address_t begin, address_t end, std::size_t step)
+        : m_begin(begin, step)
+        , m_end(end, step) {}
+
+    MYWR_INLINE constexpr page_iterator begin() const {
+      return m_begin;
+    }
+
+    MYWR_INLINE constexpr page_iterator end() const {
+      return m_end;
+    }
+
+  private:
+    page_iterator m_begin;
+    page_iterator m_end;
+  };
+
+  /**
+   * @brief Default constructor. Creates the empty range.
+   */
+  constexpr address_range() = default;
+
+  /**
+   * @brief Main constructor.
+   *
+   * @param[in] begin The first address.
+   * @param[in] end   The address after the last one.
+   */
+  constexpr address_range(const address& begin, const address& end)
+      : m_begin(begin.value())
+      , m_end(end.value() < begin.value() ? begin.value() : end.value()) {}
+
+  /**
+   * @brief Creates the range of `size` bytes at `begin`.
+   */
+  static constexpr address_range from_size(const address& begin,
+                                           const std::size_t size) {
+    return {begin, begin.value() + static_cast<address_t>(size)};
+  }
+
+  /**
+   * @brief Returns the first address.
+   */
+  MYWR_INLINE constexpr address_t begin() const {
+    return m_begin;
+  }
+
+  /**
+   * @brief Returns the address after the last one.
+   */
+  MYWR_INLINE constexpr address_t end() const {
+    return m_end;
+  }
+
+  /**
+   * @brief Returns the size of the range.
+   */
+  MYWR_INLINE constexpr std::size_t size() const {
+    return static_cast<std::size_t>(m_end - m_begin);
+  }
+
+  /**
+   * @brief Returns `true` if the range is empty.
+   */
+  MYWR_INLINE constexpr bool empty() const {
+    return m_begin == m_end;
+  }
+
+  /**
+   * @brief Returns `true` if the address lies in the range.
+   */
+  MYWR_INLINE constexpr bool contains(const address& target) const {
+    return target.value() >= m_begin && target.value() < m_end;
+  }
+
+  /**
+   * @brief Returns `true` if the other range lies in the range completely.
+   */
+  MYWR_INLINE constexpr bool contains(const address_range& other) const {
+    return other.m_begin >= m_begin && other.m_end <= m_end;
+  }
+
+  /**
+   * @brief Returns `true` if the ranges have common addresses.
+   */
+  MYWR_INLINE constexpr bool overlaps(const address_range& other) const {
+    return m_begin < other.m_end && other.m_begin < m_end;
+  }
+
+  /**
+   * @brief Returns common addresses of the ranges, empty if there are none.
+   */
+  MYWR_INLINE constexpr address_range
+      intersection(const address_range& other) const {
+    if (!overlaps(other))
+      return {};
+
+    return {m_begin > other.m_begin ? m_begin : other.m_begin,
+            m_end < other.m_end ? m_end : other.m_end};
+  }
+
+  /**
+   * @brief Returns the smallest range containing both ranges. It contains
+   * the gap between them too if they neither overlap nor touch.
+   */
+  MYWR_INLINE constexpr address_range
+      merge(const address_range& other) const {
+    if (empty())
+      return other;
+    if (other.empty())
+      return *this;
+
+    return {m_begin < other.m_begin ? m_begin : other.m_begin,
+            m_end > other.m_end ? m_end : other.m_end};
+  }
+
+  /**
+   * @brief Returns the parts of the range not covered by the other range:
+   * the part before it and the part after it. Both may be empty.
+   */
+  MYWR_INLINE constexpr std::pair<address_range, address_range>
+      subtract(const address_range& other) const {
+    if (!overlaps(other))
+      return {*this, {}};
+
+    return {{m_begin, other.m_begin > m_begin ? other.m_begin : m_begin},
+            {other.m_end < m_end ? other.m_end : m_end, m_end}};
+  }
+
+  /**
+   * @brief Returns the range extended to the alignment: the begin is
+   * rounded down, the end is rounded up.
+   *
+   * @param[in] alignment The power of two.
+   */
+  MYWR_INLINE constexpr address_range
+      aligned(const std::size_t alignment) const {
+    address_t mask = static_cast<address_t>(alignment - 1);
+    return {m_begin & ~mask, (m_end + mask) & ~mask};
+  }
+
+  /**
+   * @brief Returns the range extended to whole pages.
+   */
+  MYWR_INLINE address_range page_aligned() const {
+    return aligned(page_size());
+  }
+
+  /**
+   * @brief Returns the range extended to whole huge pages, or to whole pages
+   * if huge pages are not supported.
+   */
+  MYWR_INLINE address_range huge_page_aligned() const {
+    std::size_t size = huge_page_size();
+    return aligned(size ? size : page_size());
+  }
+
+  /**
+   * @brief Returns the number of pages touched by the range.
+   *
+   * @param[in] page_size The page size.
+   */
+  MYWR_INLINE std::size_t
+      page_count(const std::size_t page_size = mywr::page_size()) const {
+    return aligned(page_size).size() / page_size;
+  }
+
+  /**
+   * @brief Returns the pages touched by the range.
+   *
+   * @param[in] page_size The page size.
+   */
+  MYWR_INLINE page_list
+      pages(const std::size_t page_size = mywr::page_size()) const {
+    address_range area = aligned(page_size);
+    return {area.m_begin, area.m_end, page_size};
+  }
+
+  /**
+   * @brief Compares two ranges for equality.
+   */
+  MYWR_INLINE constexpr bool operator==(const address_range& rhs) const {
+    return m_begin == rhs.m_begin && m_end == rhs.m_end;
+  }
+
+  /**
+   * @brief Compares two ranges for inequality.
+   */
+  MYWR_INLINE constexpr bool operator!=(const address_range& rhs) const {
+    return !(*this == rhs);
+  }
+
+private:
+  /**
+   * @brief The first address.
+   */
+  address_t m_begin{};
+
+  /**
+   * @brief The address after the last one.
+   */
+  address_t m_end{};
+};
 } // namespace mywr
 
 #endif
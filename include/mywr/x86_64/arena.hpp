@@ -0,0 +1,349 @@
+/*********************************************************************
+ * @file   arena.hpp
+ * @brief  Module containing dual-mapped executable memory arenas.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_ARENA_HPP_
+#define MYWR_ARENA_HPP_
+
+#if defined(MYWR_LINUX) && defined(MFD_CLOEXEC) &&                             \
+    !defined(MYWR_FEATURE_NO_MPROTECT)
+  #define MYWR_FEATURE_DUAL_MAPPING
+#elif defined(MYWR_WINDOWS)
+  #define MYWR_FEATURE_DUAL_MAPPING
+#endif
+
+namespace mywr {
+/**
+ * @brief Namespace containing executable memory arenas.
+ */
+namespace arena {
+/**
+ * @brief Block allocated in the @ref code_arena.
+ */
+struct block {
+  /**
+   * @brief The address of the block in the executable (RX) view.
+   */
+  address executable{0};
+
+  /**
+   * @brief The address of the block in the writable (RW) view.
+   */
+  address writable{0};
+
+  /**
+   * @brief The size of the block.
+   */
+  std::size_t size{};
+
+  /**
+   * @brief Returns `true` if the block was allocated.
+   */
+  MYWR_INLINE explicit operator bool() const {
+    return size != 0;
+  }
+};
+
+/**
+ * @class code_arena
+ * @brief Executable arena mapped twice: RX view for execution and RW view for
+ * writing.
+ *
+ * @details
+ * The same memory (`memfd_create` on Linux, pagefile-backed section on
+ * Windows) is mapped twice, so the code is never writable and executable at
+ * the same address, and writes never change protections: no `mprotect`, no
+ * TLB shootdowns, no W+X window. Suits trampolines, thunks and JIT stubs that
+ * are re-patched often.
+ *
+ * @code{.cpp}
+ * mywr::arena::code_arena arena{64 * 1024};
+ *
+ * auto stub = arena.allocate(sizeof(kStubCode));
+ * arena.write(stub.executable, kStubCode, sizeof(kStubCode));
+ *
+ * mywr::invoker::invoke<int (*)()>(stub.executable);
+ * @endcode
+ */
+class code_arena {
+public:
+  /**
+   * @name Constructors & Destructor.
+   * @{
+   */
+
+  /**
+   * @brief Default constructor forbidden.
+   */
+  code_arena() = delete;
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  code_arena(const code_arena&) = delete;
+
+  /**
+   * @brief Move constructor forbidden.
+   */
+  code_arena(code_arena&&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const code_arena&) = delete;
+
+  /**
+   * @brief Move operator forbidden.
+   */
+  void operator=(code_arena&&) = delete;
+
+  /**
+   * @brief Main constructor. Creates and maps the arena.
+   *
+   * @param[in] capacity The size of the arena. Rounded up to the page size.
+   */
+  explicit code_arena(const std::size_t capacity) {
+#if defined(MYWR_WINDOWS)
+    SYSTEM_INFO info{};
+    GetSystemInfo(&info);
+
+    std::size_t granularity = info.dwAllocationGranularity;
+    std::size_t size = (capacity + granularity - 1) / granularity * granularity;
+
+    m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE,
+                                   nullptr,
+                                   PAGE_EXECUTE_READWRITE,
+                                   static_cast<DWORD>(
+                                       static_cast<std::uint64_t>(size) >> 32),
+                                   static_cast<DWORD>(size & 0xFFFFFFFFu),
+                                   nullptr);
+    if (!m_mapping)
+      return;
+
+    void* rx = MapViewOfFile(
+        m_mapping, FILE_MAP_READ | FILE_MAP_EXECUTE, 0, 0, size);
+    void* rw = MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!rx || !rw) {
+      if (rx)
+        UnmapViewOfFile(rx);
+      if (rw)
+        UnmapViewOfFile(rw);
+      return;
+    }
+
+    m_executable = rx;
+    m_writable   = rw;
+    m_capacity   = size;
+#elif defined(MYWR_FEATURE_DUAL_MAPPING)
+    std::size_t size = address_range{0, capacity}.page_aligned().size();
+
+    m_fd = memfd_create("mywr-code-arena", MFD_CLOEXEC);
+    if (m_fd < 0)
+      return;
+
+    if (ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+      return;
+
+    void* rx = mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_SHARED, m_fd, 0);
+    void* rw =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (rx == MAP_FAILED || rw == MAP_FAILED) {
+      if (rx != MAP_FAILED)
+        munmap(rx, size);
+      if (rw != MAP_FAILED)
+        munmap(rw, size);
+      return;
+    }
+
+    m_executable = rx;
+    m_writable   = rw;
+    m_capacity   = size;
+#endif
+  }
+
+  /**
+   * @brief Destructor. Unmaps both views.
+   */
+  ~code_arena() {
+#if defined(MYWR_WINDOWS)
+    if (good()) {
+      UnmapViewOfFile(m_executable);
+      UnmapViewOfFile(m_writable);
+    }
+    if (m_mapping)
+      CloseHandle(m_mapping);
+#elif defined(MYWR_FEATURE_DUAL_MAPPING)
+    if (good()) {
+      munmap(m_executable, m_capacity);
+      munmap(m_writable, m_capacity);
+    }
+    if (m_fd >= 0)
+      ::close(m_fd);
+#endif
+  }
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Public Member Functions
+   * @{
+   */
+
+  /**
+   * @brief Returns `true` if the arena was mapped.
+   */
+  MYWR_INLINE bool good() const {
+    return m_capacity != 0;
+  }
+
+  /**
+   * @brief Returns the size of the arena.
+   */
+  MYWR_INLINE std::size_t capacity() const {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Returns the number of allocated bytes, including alignment.
+   */
+  MYWR_INLINE std::size_t used() const {
+    return m_used.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the begin of the executable view.
+   */
+  MYWR_INLINE address executable() const {
+    return m_executable;
+  }
+
+  /**
+   * @brief Returns the begin of the writable view.
+   */
+  MYWR_INLINE address writable() const {
+    return m_writable;
+  }
+
+  /**
+   * @brief Allocates the block. Thread-safe, blocks are never freed
+   * individually.
+   *
+   * @param[in] size      The size of the block.
+   * @param[in] alignment The alignment of the block, power of two.
+   *
+   * @return Allocated block or empty one if the arena is exhausted.
+   */
+  block allocate(const std::size_t size, const std::size_t alignment = 16) {
+    if (!good() || size == 0)
+      return {};
+
+    std::size_t used = m_used.load(std::memory_order_relaxed);
+    std::size_t offset{};
+    do {
+      offset = (used + alignment - 1) & ~(alignment - 1);
+      if (offset + size > m_capacity)
+        return {};
+    } while (!m_used.compare_exchange_weak(
+        used, offset + size, std::memory_order_relaxed));
+
+    return {m_executable.value() + offset, m_writable.value() + offset, size};
+  }
+
+  /**
+   * @brief Returns `true` if the address belongs to the executable view.
+   */
+  MYWR_INLINE bool contains(const address& executable) const {
+    return executable.value() >= m_executable.value() &&
+           executable.value() < m_executable.value() + m_capacity;
+  }
+
+  /**
+   * @brief Translates the address in the executable view to the writable
+   * view.
+   */
+  MYWR_INLINE address to_writable(const address& executable) const {
+    return m_writable.value() + (executable.value() - m_executable.value());
+  }
+
+  /**
+   * @brief Translates the address in the writable view to the executable
+   * view.
+   */
+  MYWR_INLINE address to_executable(const address& writable) const {
+    return m_executable.value() + (writable.value() - m_writable.value());
+  }
+
+  /**
+   * @brief Writes the code through the writable view and flushes the
+   * instruction cache of the executable view.
+   *
+   * @param[in] dest The address in the executable view.
+   * @param[in] src  The code to write.
+   * @param[in] size The size of the code.
+   *
+   * @return `false` if `dest` doesn't belong to the arena.
+   */
+  bool write(const address& dest, const address& src, const std::size_t size) {
+    if (!contains(dest) || !contains(dest.value() + size - 1))
+      return false;
+
+    ::memcpy(to_writable(dest), src, size);
+    return llmo::flush(dest, size);
+  }
+
+  /**
+   * @}
+   */
+
+private:
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief The begin of the executable (RX) view.
+   */
+  address m_executable{0};
+
+  /**
+   * @brief The begin of the writable (RW) view.
+   */
+  address m_writable{0};
+
+  /**
+   * @brief The size of the arena.
+   */
+  std::size_t m_capacity{};
+
+  /**
+   * @brief Bump allocator offset.
+   */
+  std::atomic<std::size_t> m_used{0};
+
+#if defined(MYWR_WINDOWS)
+  /**
+   * @brief Section backing both views.
+   */
+  HANDLE m_mapping{};
+#else
+  /**
+   * @brief `memfd` backing both views.
+   */
+  int m_fd{-1};
+#endif
+
+  /**
+   * @}
+   */
+};
+} // namespace arena
+} // namespace mywr
+
+#endif // !MYWR_ARENA_HPP_
@@ -50,6 +50,50 @@ MYWR_INLINE instruction disassemble(const address& code) {
 #endif
   return insn;
 }
+
+/**
+ * @brief Disassembles the code range instruction by instruction.
+ *
+ * @details
+ * Stops at the end of the range, before an instruction crossing it, at an
+ * invalid instruction or when the callback returns `false`. Up to 15 bytes
+ * past the last instruction may be read, they must be readable.
+ *
+ * @code{.cpp}
+ * std::size_t calls = 0;
+ * mywr::disassembler::disassemble(function, 64, [&](auto, const auto& insn) {
+ *   calls += insn.opcode == 0xE8;
+ * });
+ * @endcode
+ *
+ * @param[in] code     The begin of the code.
+ * @param[in] size     The size of the code.
+ * @param[in] callback Callable taking the address and `const instruction&`,
+ * may return `bool`.
+ *
+ * @return The number of bytes disassembled.
+ */
+template<typename Fn>
+std::size_t disassemble(const address& code, std::size_t size, Fn&& callback) {
+  MYWR_TRACE_SCOPE("disassembler::disassemble", size);
+
+  std::size_t offset = 0;
+  while (offset < size) {
+    address     at   = code.value() + offset;
+    instruction insn = disassemble(at);
+    if ((insn.flags & F_ERROR) || insn.len == 0 || offset + insn.len > size)
+      break;
+
+    offset += insn.len;
+    if constexpr (std::is_same_v<decltype(callback(at, insn)), bool>) {
+      if (!callback(at, insn))
+        break;
+    } else {
+      callback(at, insn);
+    }
+  }
+  return offset;
+}
 } // namespace disassembler
 } // namespace mywr
 
@@ -31,10 +31,14 @@ namespace llmo {
  * @return Success of flushing.
  */
 MYWR_FORCEINLINE bool flush(const address& dest, const std::size_t size) {
+  MYWR_STATS_TIMER(kFlush);
+
 #if defined(MYWR_WINDOWS)
+  MYWR_STATS_COUNT(kSyscall);
   return FlushInstructionCache(GetCurrentProcess(), dest, size) != 0;
 #elif defined(MYWR_UNIX) && !defined(MYWR_FEATURE_NO_FLUSH_CACHE)
-  return cacheflush(target, size, ICACHE) == 0;
+  MYWR_STATS_COUNT(kSyscall);
+  return cacheflush(dest, size, ICACHE) == 0;
 #else
   return true;
 #endif
@@ -88,6 +92,124 @@ MYWR_FORCEINLINE void write(const address& dest, T value) {
   flush(dest, sizeof(T));
 }
 
+/**
+ * @brief Reads the object at the memory address into `out`.
+ *
+ * @details
+ * The whole object is unprotected once and copied in bulk, so it suits big
+ * structures which would take many @ref read calls field by field.
+ *
+ * @code{.cpp}
+ * player_info info;
+ * mywr::llmo::read_into(0xDEADBEEF, info);
+ * @endcode
+ *
+ * @tparam T The type of the object. Must be trivially copyable.
+ *
+ * @param[in]  src The address of the memory where the object is stored.
+ * @param[out] out The object to read into.
+ */
+template<typename T>
+MYWR_FORCEINLINE void read_into(const address& src, T& out) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "read_into requires trivially copyable type");
+
+  // Unprotect memory region.
+  protect::scoped_protect protect(
+      src, sizeof(T), protect::memory_prot::kExecuteReadWrite);
+  // And copy the object.
+  ::memcpy(&out, src, sizeof(T));
+}
+
+/**
+ * @brief Reads the array of objects at the memory address into `out`.
+ *
+ * @details
+ * The whole array is unprotected once and copied in bulk.
+ *
+ * @tparam T The type of the elements. Must be trivially copyable.
+ *
+ * @param[in]  src   The address of the memory where the array is stored.
+ * @param[out] out   The array to read into, at least `count` elements.
+ * @param[in]  count The number of elements.
+ */
+template<typename T>
+MYWR_FORCEINLINE void
+    read_span(const address& src, T* out, const std::size_t count) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "read_span requires trivially copyable type");
+
+  if (count == 0)
+    return;
+
+  // Unprotect memory region.
+  protect::scoped_protect protect(
+      src, sizeof(T) * count, protect::memory_prot::kExecuteReadWrite);
+  // And copy the array.
+  ::memcpy(out, src, sizeof(T) * count);
+}
+
+/**
+ * @brief Reads the array of objects at the memory address.
+ *
+ * @code{.cpp}
+ * auto entities = mywr::llmo::read_span<entity>(0xDEADBEEF, 10000);
+ * @endcode
+ *
+ * @tparam T The type of the elements. Must be trivially copyable.
+ *
+ * @param[in] src   The address of the memory where the array is stored.
+ * @param[in] count The number of elements.
+ *
+ * @return The array.
+ */
+template<typename T>
+MYWR_FORCEINLINE std::vector<T> read_span(const address&    src,
+                                          const std::size_t count) {
+  std::vector<T> result(count);
+  read_span(src, result.data(), count);
+  return result;
+}
+
+/**
+ * @brief Writes the array of objects to the memory address.
+ *
+ * @details
+ * The whole array is unprotected once, copied in bulk and the CPU's cache is
+ * flushed once.
+ *
+ * @code{.cpp}
+ * std::vector<entity> entities = build_entities();
+ * mywr::llmo::write_span(0xDEADBEEF, entities.data(), entities.size());
+ * @endcode
+ *
+ * @tparam T The type of the elements. Must be trivially copyable.
+ *
+ * @param[in] dest   The address in memory where the array needs to be
+ * written.
+ * @param[in] values The array to write.
+ * @param[in] count  The number of elements.
+ */
+template<typename T>
+MYWR_FORCEINLINE void
+    write_span(const address& dest, const T* values, const std::size_t count) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "write_span requires trivially copyable type");
+
+  if (count == 0)
+    return;
+
+  // Unprotect memory region.
+  protect::scoped_protect protect(
+      dest, sizeof(T) * count, protect::memory_prot::kExecuteReadWrite);
+
+  // Copy the array.
+  ::memcpy(dest, values, sizeof(T) * count);
+
+  // Flush the CPU's cache.
+  flush(dest, sizeof(T) * count);
+}
+
 /**
  * @brief Copies bytes from a source memory area to a destination memory area,
  * where both areas may not overlap.
@@ -102,6 +224,8 @@ MYWR_FORCEINLINE void write(const address& dest, T value) {
  */
 MYWR_FORCEINLINE void
     copy(const address& dest, const address& src, const std::size_t size) {
+  MYWR_TRACE_SCOPE("llmo::copy", size);
+
   // Unprotect memory region.
   protect::scoped_protect protect(
       dest, size, protect::memory_prot::kExecuteReadWrite);
@@ -111,6 +235,150 @@ MYWR_FORCEINLINE void
   flush(dest, size);
 }
 
+namespace impl {
+/**
+ * @brief Stores `N` bytes merged into the aligned 8-byte word containing
+ * them by one move. Not atomic: writes of the other bytes of the word made
+ * by other threads between the load and the store are lost.
+ */
+template<std::size_t N>
+MYWR_FORCEINLINE void store_merged(byte_t* dest, const byte_t* src) {
+  static_assert(N < 8, "store_merged requires less than 8 bytes");
+
+  constexpr std::uint64_t kMask = (std::uint64_t{1} << (N * 8)) - 1;
+
+  auto  shift = (reinterpret_cast<std::uintptr_t>(dest) & 7) * 8;
+  auto* word  = reinterpret_cast<std::atomic<std::uint64_t>*>(dest - shift / 8);
+
+  std::uint64_t value{};
+  ::memcpy(&value, src, N);
+
+  std::uint64_t merged = word->load(std::memory_order_relaxed);
+  merged = (merged & ~(kMask << shift)) | (value << shift);
+  word->store(merged, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stores `N` bytes by as few stores as possible.
+ *
+ * @details
+ * Naturally aligned 1, 2, 4 and 8 bytes are stored by one move. With `merge`
+ * up to 7 bytes inside an aligned 8-byte word are merged with the surrounding
+ * bytes and stored by one 8-byte move, which x86-64 performs atomically, so
+ * other threads executing the patched code never see a half written
+ * instruction. If SSE2 is enabled at compile time, up to 16 bytes inside an
+ * aligned 16-byte block are stored by one SSE move, which is a single
+ * instruction but not guaranteed to be atomic on every CPU. Otherwise one or
+ * two unaligned moves are used.
+ *
+ * Merging reads and writes back the surrounding bytes, so it loses concurrent
+ * writes to them. Use it only for code, never for data other threads write.
+ *
+ * @param[in] dest  The memory area to store to.
+ * @param[in] src   The bytes.
+ * @param[in] merge Merge the bytes with the surrounding ones.
+ */
+template<std::size_t N>
+MYWR_FORCEINLINE void
+    store_bytes(byte_t* dest, const byte_t* src, const bool merge) {
+  auto misalignment = reinterpret_cast<std::uintptr_t>(dest);
+
+  if constexpr (N == 1 || N == 2 || N == 4 || N == 8) {
+    if ((misalignment & (N - 1)) == 0) {
+      using word_t = std::conditional_t<
+          N == 1,
+          std::uint8_t,
+          std::conditional_t<N == 2,
+                             std::uint16_t,
+                             std::conditional_t<N == 4,
+                                                std::uint32_t,
+                                                std::uint64_t>>>;
+      word_t word;
+      ::memcpy(&word, src, N);
+      reinterpret_cast<std::atomic<word_t>*>(dest)->store(
+          word, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  if constexpr (N < 8) {
+    if (merge && (misalignment & 7) + N <= 8)
+      return store_merged<N>(dest, src);
+  }
+
+#if defined(MYWR_FEATURE_STREAMING) && (defined(__SSE2__) || defined(_M_X64))
+  if constexpr (N <= 16) {
+    if (merge && (misalignment & 15) + N <= 16) {
+      auto    offset = misalignment & 15;
+      auto*   block  = reinterpret_cast<__m128i*>(dest - offset);
+      __m128i merged = _mm_load_si128(block);
+      ::memcpy(reinterpret_cast<byte_t*>(&merged) + offset, src, N);
+      _mm_store_si128(block, merged);
+      return;
+    }
+  }
+#endif
+
+  // Compilers emit one or two overlapping moves for constant sizes.
+  ::memcpy(dest, src, N);
+}
+} // namespace impl
+
+/**
+ * @brief Copies `N` bytes from a source memory area to a destination memory
+ * area, where both areas may not overlap.
+ *
+ * @details
+ * Same as the runtime-size @ref copy, but the copy compiles to one or two
+ * moves. Patches of executable memory of up to 16 bytes which don't cross an
+ * aligned 8-byte word or 16-byte block are merged with the surrounding bytes
+ * and stored by a single move, see `impl::store_bytes`. Data is copied as
+ * is, so concurrent writes of the neighbouring bytes are never lost.
+ *
+ * @code{.cpp}
+ * mywr::llmo::copy<5>(0xDEADBEEF, jump);
+ * @endcode
+ *
+ * @tparam N The number of bytes to copy.
+ *
+ * @param[in]  dest The memory area to copy to.
+ * @param[in]  src  The memory area to copy from.
+ */
+template<std::size_t N>
+MYWR_FORCEINLINE void copy(const address& dest, const address& src) {
+  static_assert(N != 0, "copy requires non-zero size");
+
+  // Unprotect memory region.
+  protect::scoped_protect protect(
+      dest, N, protect::memory_prot::kExecuteReadWrite);
+  // Store the bytes, merged only into code.
+  bool  code   = protect.old_protect() & protect::memory_prot::kExecute;
+  auto* source = static_cast<const byte_t*>(static_cast<const void*>(src));
+  impl::store_bytes<N>(
+      static_cast<byte_t*>(static_cast<void*>(dest)), source, code);
+  // And flush CPU's cache.
+  flush(dest, N);
+}
+
+/**
+ * @brief Writes the bytes to the memory address, see @ref copy with
+ * fixed size.
+ *
+ * @code{.cpp}
+ * mywr::llmo::write_bytes<5>(0xDEADBEEF, {0xE9, 0x00, 0x00, 0x00, 0x00});
+ * @endcode
+ *
+ * @tparam N The number of bytes to write.
+ *
+ * @param[in] dest  The address in memory where the bytes need to be written.
+ * @param[in] bytes The bytes.
+ */
+template<std::size_t N>
+MYWR_FORCEINLINE void write_bytes(const address&               dest,
+                                  const std::array<byte_t, N>& bytes) {
+  copy<N>(dest, bytes.data());
+}
+
 /**
  * @brief Fills a value to a destination memory area with specified size.
  *
@@ -124,6 +392,8 @@ MYWR_FORCEINLINE void
  */
 MYWR_FORCEINLINE void
     fill(const address& dest, const int value, const std::size_t size) {
+  MYWR_TRACE_SCOPE("llmo::fill", size);
+
   // Unprotect memory region.
   protect::scoped_protect protect(
       dest, size, protect::memory_prot::kExecuteReadWrite);
@@ -135,6 +405,1132 @@ MYWR_FORCEINLINE void
   flush(dest, size);
 }
 
+/**
+ * @brief Areas at least that big are written by @ref stream_fill and
+ * @ref stream_copy with non-temporal stores. Smaller ones likely are read
+ * soon and fit the cache anyway.
+ */
+constexpr std::size_t kStreamThreshold = 1024 * 1024;
+
+#if defined(MYWR_FEATURE_STREAMING)
+namespace impl {
+/**
+ * @brief Returns `true` if the CPU and the OS support AVX.
+ */
+inline bool has_avx() {
+  static const bool result = [] {
+  #if defined(MYWR_MSVC)
+    int info[4]{};
+    __cpuid(info, 1);
+
+    // OSXSAVE and AVX, then the OS saves YMM state.
+    constexpr int kOsxsaveAvx = (1 << 27) | (1 << 28);
+    return (info[2] & kOsxsaveAvx) == kOsxsaveAvx && (_xgetbv(0) & 6) == 6;
+  #else
+    return __builtin_cpu_supports("avx") != 0;
+  #endif
+  }();
+  return result;
+}
+
+/**
+ * @brief Returns the number of bytes before the next `alignment` boundary.
+ */
+MYWR_INLINE std::size_t head_of(const void* dest, std::size_t alignment) {
+  auto misalignment = reinterpret_cast<std::uintptr_t>(dest) & (alignment - 1);
+  return (alignment - misalignment) & (alignment - 1);
+}
+
+/**
+ * @brief Fills with 16-byte non-temporal stores.
+ */
+MYWR_TARGET("sse2")
+inline void stream_fill_sse2(byte_t* dest, int value, std::size_t size) {
+  std::size_t head = std::min(head_of(dest, 16), size);
+  ::memset(dest, value, head);
+  dest += head;
+  size -= head;
+
+  __m128i vector = _mm_set1_epi8(static_cast<char>(value));
+  for (; size >= 64; dest += 64, size -= 64) {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest), vector);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest + 16), vector);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest + 32), vector);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest + 48), vector);
+  }
+  for (; size >= 16; dest += 16, size -= 16)
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest), vector);
+
+  // Non-temporal stores are weakly ordered.
+  _mm_sfence();
+  ::memset(dest, value, size);
+}
+
+/**
+ * @brief Copies with 16-byte non-temporal stores.
+ */
+MYWR_TARGET("sse2")
+inline void
+    stream_copy_sse2(byte_t* dest, const byte_t* src, std::size_t size) {
+  std::size_t head = std::min(head_of(dest, 16), size);
+  ::memcpy(dest, src, head);
+  dest += head;
+  src += head;
+  size -= head;
+
+  for (; size >= 64; dest += 64, src += 64, size -= 64) {
+    auto* from = reinterpret_cast<const __m128i*>(src);
+    auto* to   = reinterpret_cast<__m128i*>(dest);
+
+    __m128i v0 = _mm_loadu_si128(from);
+    __m128i v1 = _mm_loadu_si128(from + 1);
+    __m128i v2 = _mm_loadu_si128(from + 2);
+    __m128i v3 = _mm_loadu_si128(from + 3);
+    _mm_stream_si128(to, v0);
+    _mm_stream_si128(to + 1, v1);
+    _mm_stream_si128(to + 2, v2);
+    _mm_stream_si128(to + 3, v3);
+  }
+  for (; size >= 16; dest += 16, src += 16, size -= 16)
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+
+  _mm_sfence();
+  ::memcpy(dest, src, size);
+}
+
+/**
+ * @brief Fills with 32-byte non-temporal stores.
+ */
+MYWR_TARGET("avx")
+inline void stream_fill_avx(byte_t* dest, int value, std::size_t size) {
+  std::size_t head = std::min(head_of(dest, 32), size);
+  ::memset(dest, value, head);
+  dest += head;
+  size -= head;
+
+  __m256i vector = _mm256_set1_epi8(static_cast<char>(value));
+  for (; size >= 128; dest += 128, size -= 128) {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dest), vector);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + 32), vector);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + 64), vector);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + 96), vector);
+  }
+  for (; size >= 32; dest += 32, size -= 32)
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dest), vector);
+
+  _mm_sfence();
+  ::memset(dest, value, size);
+}
+
+/**
+ * @brief Copies with 32-byte non-temporal stores.
+ */
+MYWR_TARGET("avx")
+inline void stream_copy_avx(byte_t* dest, const byte_t* src, std::size_t size) {
+  std::size_t head = std::min(head_of(dest, 32), size);
+  ::memcpy(dest, src, head);
+  dest += head;
+  src += head;
+  size -= head;
+
+  for (; size >= 128; dest += 128, src += 128, size -= 128) {
+    auto* from = reinterpret_cast<const __m256i*>(src);
+    auto* to   = reinterpret_cast<__m256i*>(dest);
+
+    __m256i v0 = _mm256_loadu_si256(from);
+    __m256i v1 = _mm256_loadu_si256(from + 1);
+    __m256i v2 = _mm256_loadu_si256(from + 2);
+    __m256i v3 = _mm256_loadu_si256(from + 3);
+    _mm256_stream_si256(to, v0);
+    _mm256_stream_si256(to + 1, v1);
+    _mm256_stream_si256(to + 2, v2);
+    _mm256_stream_si256(to + 3, v3);
+  }
+  for (; size >= 32; dest += 32, src += 32, size -= 32)
+    _mm256_stream_si256(
+        reinterpret_cast<__m256i*>(dest),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+
+  _mm_sfence();
+  ::memcpy(dest, src, size);
+}
+} // namespace impl
+#endif
+
+/**
+ * @brief Fills a value to a destination memory area bypassing the CPU's
+ * cache.
+ *
+ * @details
+ * Areas of at least `threshold` bytes are written with non-temporal stores
+ * (`vmovntdq` if AVX is available, `movntdq` otherwise) followed by `sfence`,
+ * so wiping huge areas doesn't evict the cache used by other code. Smaller
+ * areas are filled by @ref fill.
+ *
+ * @code{.cpp}
+ * mywr::llmo::stream_fill(buffer, 0, 512 * 1024 * 1024);
+ * @endcode
+ *
+ * @param[in] dest      The memory area to fill.
+ * @param[in] value     The value to fill in.
+ * @param[in] size      The number of bytes to fill.
+ * @param[in] threshold The minimal size to stream.
+ */
+MYWR_FORCEINLINE void
+    stream_fill(const address&    dest,
+                const int         value,
+                const std::size_t size,
+                const std::size_t threshold = kStreamThreshold) {
+#if defined(MYWR_FEATURE_STREAMING)
+  if (size >= threshold) {
+    MYWR_TRACE_SCOPE("llmo::stream_fill", size);
+
+    // Unprotect memory region.
+    protect::scoped_protect protect(
+        dest, size, protect::memory_prot::kExecuteReadWrite);
+
+    auto* destination = static_cast<byte_t*>(static_cast<void*>(dest));
+    if (impl::has_avx())
+      impl::stream_fill_avx(destination, value, size);
+    else
+      impl::stream_fill_sse2(destination, value, size);
+
+    // Flush CPU's cache.
+    flush(dest, size);
+    return;
+  }
+#endif
+
+  fill(dest, value, size);
+}
+
+/**
+ * @brief Copies bytes from a source memory area to a destination memory area
+ * bypassing the CPU's cache. Both areas may not overlap.
+ *
+ * @details
+ * Same as @ref stream_fill: areas of at least `threshold` bytes are written
+ * with non-temporal stores, smaller ones are copied by @ref copy.
+ *
+ * @code{.cpp}
+ * mywr::llmo::stream_copy(snapshot, heap, heap_size);
+ * @endcode
+ *
+ * @param[in] dest      The memory area to copy to.
+ * @param[in] src       The memory area to copy from.
+ * @param[in] size      The number of bytes to copy.
+ * @param[in] threshold The minimal size to stream.
+ */
+MYWR_FORCEINLINE void
+    stream_copy(const address&    dest,
+                const address&    src,
+                const std::size_t size,
+                const std::size_t threshold = kStreamThreshold) {
+#if defined(MYWR_FEATURE_STREAMING)
+  if (size >= threshold) {
+    MYWR_TRACE_SCOPE("llmo::stream_copy", size);
+
+    // Unprotect memory region.
+    protect::scoped_protect protect(
+        dest, size, protect::memory_prot::kExecuteReadWrite);
+
+    auto* destination = static_cast<byte_t*>(static_cast<void*>(dest));
+    auto* source = static_cast<const byte_t*>(static_cast<const void*>(src));
+    if (impl::has_avx())
+      impl::stream_copy_avx(destination, source, size);
+    else
+      impl::stream_copy_sse2(destination, source, size);
+
+    // Flush CPU's cache.
+    flush(dest, size);
+    return;
+  }
+#endif
+
+  copy(dest, src, size);
+}
+
+#if defined(MYWR_LINUX)
+namespace impl {
+/**
+ * @brief Returns the process-wide descriptor of /proc/self/mem, reopened in
+ * forked children so they never write to the parent.
+ */
+inline int mem_descriptor() {
+  static procfs::impl::process_descriptor mem{"/proc/self/mem", O_RDWR};
+  return mem.get();
+}
+} // namespace impl
+#endif
+
+/**
+ * @brief Writes bytes to the memory area regardless of its protection.
+ *
+ * @details
+ * On Linux writes through /proc/self/mem: the kernel forces the write into
+ * read-only and executable mappings, so protections are never changed and
+ * no TLB shootdowns happen, and concurrent code executing the other bytes of
+ * the page isn't affected. On Windows uses `WriteProcessMemory`. On other
+ * systems falls back to @ref copy.
+ *
+ * @code{.cpp}
+ * mywr::llmo::force_write(0xDEADBEEF, "\x90\x90", 2);
+ * @endcode
+ *
+ * @param[in] dest The memory area to write to.
+ * @param[in] src  The memory area to copy from.
+ * @param[in] size The number of bytes to write.
+ *
+ * @return `true` if all bytes were written.
+ */
+inline bool force_write(const address&    dest,
+                       const address&    src,
+                       const std::size_t size) {
+#if defined(MYWR_LINUX)
+  int fd = impl::mem_descriptor();
+  if (fd < 0)
+    return false;
+
+  const void* source  = src;
+  auto*       bytes   = static_cast<const byte_t*>(source);
+  std::size_t written = 0;
+  while (written < size) {
+    MYWR_STATS_COUNT(kSyscall);
+    ssize_t count = pwrite(fd,
+                           bytes + written,
+                           size - written,
+                           static_cast<off_t>(dest.value() + written));
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      return false;
+
+    written += static_cast<std::size_t>(count);
+  }
+#elif defined(MYWR_WINDOWS)
+  SIZE_T written = 0;
+  if (!WriteProcessMemory(GetCurrentProcess(), dest, src, size, &written) ||
+      written != size)
+    return false;
+#else
+  copy(dest, src, size);
+  return true;
+#endif
+
+  return flush(dest, size);
+}
+
+/**
+ * @brief Writes data to an address in memory regardless of its protection.
+ *
+ * @code{.cpp}
+ * mywr::llmo::force_write<uint8_t>(0xDEADBEEF, 0xC3);
+ * @endcode
+ *
+ * @tparam T The type of data to be written.
+ *
+ * @param[in] dest  The address in memory where the data needs to be written.
+ * @param[in] value The data that needs to be written.
+ *
+ * @return `true` if the data was written.
+ */
+template<typename T>
+MYWR_FORCEINLINE bool force_write(const address& dest, T value) {
+  return force_write(dest, &value, sizeof(T));
+}
+
+/**
+ * @brief Single write of the @ref force_write batch.
+ */
+struct patch {
+  /**
+   * @brief The memory area to write to.
+   */
+  address dest{0};
+
+  /**
+   * @brief The memory area to copy from.
+   */
+  const void* src{};
+
+  /**
+   * @brief The number of bytes to write.
+   */
+  std::size_t size{};
+};
+
+/**
+ * @brief Writes the batch of patches regardless of protection.
+ *
+ * @details
+ * On Linux adjacent patches (each starts where the previous one ends) are
+ * gathered into one buffer and written by a single `pwrite`, so patching a
+ * sequence of instructions costs one system call. /proc/self/mem doesn't
+ * implement vectored writes, `pwritev` would still cost a write per patch.
+ *
+ * @code{.cpp}
+ * mywr::llmo::patch patches[]{
+ *     {0xDEADBEEF, "\xE9",  1},
+ *     {0xDEADBEF0, &offset, 4},
+ * };
+ * mywr::llmo::force_write(patches, std::size(patches));
+ * @endcode
+ *
+ * @param[in] patches The patches to write.
+ * @param[in] count   The number of patches.
+ *
+ * @return `true` if all patches were written.
+ */
+inline bool force_write(const patch* patches, const std::size_t count) {
+#if defined(MYWR_LINUX)
+  constexpr std::size_t kBufferSize = 4096;
+
+  byte_t buffer[kBufferSize];
+
+  bool        result = true;
+  std::size_t begin  = 0;
+  while (begin < count) {
+    /**
+     * Patches not fitting the buffer are written directly.
+     */
+    if (patches[begin].size > kBufferSize) {
+      result &= force_write(
+          patches[begin].dest, patches[begin].src, patches[begin].size);
+      begin++;
+      continue;
+    }
+
+    /**
+     * Gather the run of adjacent patches.
+     */
+    address_t   offset = patches[begin].dest.value();
+    std::size_t total  = 0;
+    std::size_t end    = begin;
+    for (; end < count; end++) {
+      const patch& entry = patches[end];
+      if (entry.dest.value() != offset + total ||
+          total + entry.size > kBufferSize)
+        break;
+
+      ::memcpy(buffer + total, entry.src, entry.size);
+      total += entry.size;
+    }
+
+    result &= force_write(offset, buffer, total);
+    begin = end;
+  }
+
+  return result;
+#else
+  bool result = true;
+  for (std::size_t i = 0; i < count; i++)
+    result &= force_write(patches[i].dest, patches[i].src, patches[i].size);
+  return result;
+#endif
+}
+
+#if defined(MYWR_LINUX)
+namespace impl {
+
+/**
+ * @brief `process_vm_readv` is unavailable (old kernel or seccomp), use
+ * /proc/self/mem instead.
+ */
+inline std::atomic<bool> g_no_vm_readv{false};
+
+/**
+ * @brief Returns the process id used by `process_vm_readv`, cached together
+ * with the fork generation it was taken in.
+ */
+inline pid_t process_id() {
+  static std::atomic<std::uint64_t> cached{0};
+
+  std::uint64_t generation = procfs::impl::fork_generation() + 1ull;
+  std::uint64_t value      = cached.load(std::memory_order_relaxed);
+  if ((value >> 32) != generation) {
+    value = generation << 32 | static_cast<std::uint32_t>(getpid());
+    cached.store(value, std::memory_order_relaxed);
+  }
+  return static_cast<pid_t>(value & 0xFFFFFFFF);
+}
+
+/**
+ * @brief Reads the values of pointer-sized slots by one system call.
+ *
+ * @return The number of slots read, stops at the first unreadable one.
+ */
+inline std::size_t read_slots(const address_t* slots,
+                              address_t*       values,
+                              std::size_t      count) {
+  constexpr std::size_t kMaxVectors = 64;
+
+  std::size_t done = 0;
+  while (done < count && !g_no_vm_readv.load(std::memory_order_relaxed)) {
+    struct iovec local[kMaxVectors];
+    struct iovec remote[kMaxVectors];
+
+    std::size_t batch = std::min(count - done, kMaxVectors);
+    for (std::size_t i = 0; i < batch; i++) {
+      local[i]  = {&values[done + i], sizeof(address_t)};
+      remote[i] = {reinterpret_cast<void*>(slots[done + i]), sizeof(address_t)};
+    }
+
+    MYWR_STATS_COUNT(kSyscall);
+    ssize_t read = process_vm_readv(process_id(),
+                                    local,
+                                    static_cast<unsigned long>(batch),
+                                    remote,
+                                    static_cast<unsigned long>(batch),
+                                    0);
+    if (read < 0) {
+      if (errno == ENOSYS || errno == EPERM) {
+        g_no_vm_readv.store(true, std::memory_order_relaxed);
+        break;
+      }
+      return done;
+    }
+
+    std::size_t slots_read = static_cast<std::size_t>(read) / sizeof(address_t);
+    done += slots_read;
+    if (slots_read != batch)
+      return done;
+  }
+
+  /**
+   * Fallback: positional reads of /proc/self/mem, one per slot.
+   */
+  for (int fd = mem_descriptor(); done < count; done++) {
+    MYWR_STATS_COUNT(kSyscall);
+    if (fd < 0 || pread(fd,
+                        &values[done],
+                        sizeof(address_t),
+                        static_cast<off_t>(slots[done])) !=
+                      static_cast<ssize_t>(sizeof(address_t)))
+      break;
+  }
+  return done;
+}
+} // namespace impl
+#endif
+
+/**
+ * @brief Reads data at the memory address without faulting on unreadable
+ * memory.
+ *
+ * @details
+ * On Linux uses `process_vm_readv` on the own process, on Windows uses
+ * `ReadProcessMemory`. Protections are not changed. On other systems the
+ * memory is read directly.
+ *
+ * @code{.cpp}
+ * uint32_t health{};
+ * if (mywr::llmo::try_read(0xDEADBEEF, health))
+ *   show(health);
+ * @endcode
+ *
+ * @tparam T The type of data to be read. Must be trivially copyable.
+ *
+ * @param[in]  src The address of the memory where the data is stored.
+ * @param[out] out The data.
+ *
+ * @return `true` if the memory was readable.
+ */
+template<typename T>
+MYWR_FORCEINLINE bool try_read(const address& src, T& out) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "try_read requires trivially copyable type");
+
+#if defined(MYWR_LINUX)
+  iovec local{&out, sizeof(T)};
+  iovec remote{src, sizeof(T)};
+
+  if (!impl::g_no_vm_readv.load(std::memory_order_relaxed)) {
+    MYWR_STATS_COUNT(kSyscall);
+    ssize_t read =
+        process_vm_readv(impl::process_id(), &local, 1, &remote, 1, 0);
+    if (read >= 0 || (errno != ENOSYS && errno != EPERM))
+      return read == static_cast<ssize_t>(sizeof(T));
+
+    impl::g_no_vm_readv.store(true, std::memory_order_relaxed);
+  }
+
+  int fd = impl::mem_descriptor();
+  MYWR_STATS_COUNT(kSyscall);
+  return fd >= 0 &&
+         pread(fd, &out, sizeof(T), static_cast<off_t>(src.value())) ==
+             static_cast<ssize_t>(sizeof(T));
+#elif defined(MYWR_WINDOWS)
+  SIZE_T read = 0;
+  return ReadProcessMemory(GetCurrentProcess(), src, &out, sizeof(T), &read) &&
+         read == sizeof(T);
+#else
+  ::memcpy(&out, src, sizeof(T));
+  return true;
+#endif
+}
+
+namespace impl {
+/**
+ * @brief Follows the chain with runtime offsets, see @ref resolve_chain.
+ */
+inline address_t follow_chain(address_t             pointer,
+                              const std::ptrdiff_t* offsets,
+                              std::size_t           count) {
+  for (std::size_t i = 0; i < count; i++) {
+    pointer += static_cast<address_t>(offsets[i]);
+    if (i + 1 == count)
+      break;
+
+    if (!try_read(pointer, pointer) || pointer == 0)
+      return 0;
+  }
+  return pointer;
+}
+} // namespace impl
+
+/**
+ * @brief Resolves the pointer chain.
+ *
+ * @details
+ * Every offset except the last is added to the current pointer and the
+ * result is dereferenced; the last offset is only added. So
+ * `resolve_chain(base, {0x10, 0x48, 0x8})` returns `[[base+0x10]+0x48]+0x8`,
+ * the address of the value `[[[base+0x10]+0x48]+0x8]`. Every link is read
+ * by @ref try_read, broken chains don't fault.
+ *
+ * @code{.cpp}
+ * auto health = mywr::llmo::resolve_chain(module_base, {0x10, 0x48, 0x8});
+ * if (health)
+ *   mywr::llmo::try_read(health, value);
+ * @endcode
+ *
+ * @param[in] base    The begin of the chain.
+ * @param[in] offsets The offsets.
+ *
+ * @return The resolved address or zero if some link is unreadable or null.
+ */
+inline address resolve_chain(const address&                        base,
+                             std::initializer_list<std::ptrdiff_t> offsets) {
+  return impl::follow_chain(base.value(), offsets.begin(), offsets.size());
+}
+
+namespace impl {
+/**
+ * @brief Follows the rest of the chain with compile-time offsets.
+ */
+template<std::ptrdiff_t Offset, std::ptrdiff_t... Rest>
+MYWR_FORCEINLINE address_t follow_chain(address_t pointer) {
+  pointer += static_cast<address_t>(Offset);
+  if constexpr (sizeof...(Rest) == 0) {
+    return pointer;
+  } else {
+    if (!try_read(pointer, pointer) || pointer == 0)
+      return 0;
+    return follow_chain<Rest...>(pointer);
+  }
+}
+} // namespace impl
+
+/**
+ * @brief Resolves the pointer chain with offsets known at compile time.
+ *
+ * @details
+ * Same as the @ref resolve_chain with runtime offsets, but the loop is
+ * unrolled.
+ *
+ * @code{.cpp}
+ * auto health = mywr::llmo::resolve_chain<0x10, 0x48, 0x8>(module_base);
+ * @endcode
+ *
+ * @tparam Offsets The offsets.
+ *
+ * @param[in] base The begin of the chain.
+ *
+ * @return The resolved address or zero if some link is unreadable or null.
+ */
+template<std::ptrdiff_t... Offsets>
+MYWR_FORCEINLINE address resolve_chain(const address& base) {
+  static_assert(sizeof...(Offsets) != 0, "resolve_chain requires offsets");
+
+  return impl::follow_chain<Offsets...>(base.value());
+}
+
+/**
+ * @class pointer_chain
+ * @brief Pointer chain remembering its intermediate pointers.
+ *
+ * @details
+ * The first @ref resolve walks the chain link by link. Next calls read all
+ * remembered links by one batched read (one system call on Linux) and only
+ * compare them with the remembered pointers; the chain is walked again from
+ * the first changed link only. Suits polling loops resolving the same chains
+ * many times per second. Not thread-safe.
+ *
+ * @code{.cpp}
+ * mywr::llmo::pointer_chain health{module_base, {0x10, 0x48, 0x8}};
+ *
+ * while (running) {
+ *   int value{};
+ *   if (health.read(value))
+ *     draw(value);
+ * }
+ * @endcode
+ */
+class pointer_chain {
+public:
+  /**
+   * @brief Main constructor.
+   *
+   * @param[in] base    The begin of the chain.
+   * @param[in] offsets The offsets, see @ref resolve_chain.
+   */
+  pointer_chain(const address&                        base,
+                std::initializer_list<std::ptrdiff_t> offsets)
+      : m_base(base.value())
+      , m_offsets(offsets)
+      , m_links(offsets.size() ? offsets.size() - 1 : 0)
+      , m_slots(m_links.size())
+      , m_values(m_links.size()) {}
+
+  /**
+   * @brief Returns the resolved address or zero if the chain is broken.
+   */
+  address resolve() {
+    if (m_offsets.empty())
+      return m_base;
+
+    std::size_t valid = 0;
+    if (m_resolved) {
+      /**
+       * Revalidate remembered links by one batched read.
+       */
+      std::size_t read = read_values();
+      while (valid < read && m_values[valid] == m_links[valid])
+        valid++;
+
+      if (valid == m_links.size())
+        return m_links.empty() ? m_base + offset(0) : m_address;
+
+      // The value of the first changed link is fresh, reuse it.
+      if (valid < read) {
+        m_links[valid] = m_values[valid];
+        if (m_links[valid] == 0)
+          return broken();
+        valid++;
+      }
+    }
+
+    /**
+     * Walk the rest of the chain.
+     */
+    for (std::size_t i = valid; i < m_links.size(); i++) {
+      address_t slot = (i == 0 ? m_base : m_links[i - 1]) + offset(i);
+      m_slots[i]     = slot;
+      if (!try_read(slot, m_links[i]) || m_links[i] == 0)
+        return broken();
+    }
+
+    m_resolved = true;
+    m_address  = (m_links.empty() ? m_base : m_links.back()) +
+                offset(m_offsets.size() - 1);
+    return m_address;
+  }
+
+  /**
+   * @brief Reads the value at the resolved address.
+   *
+   * @return `false` if the chain is broken or the value is unreadable.
+   */
+  template<typename T>
+  bool read(T& out) {
+    address target = resolve();
+    return target.value() != 0 && try_read(target, out);
+  }
+
+  /**
+   * @brief Forgets remembered links, the next @ref resolve walks the whole
+   * chain.
+   */
+  MYWR_INLINE void invalidate() {
+    m_resolved = false;
+  }
+
+private:
+  /**
+   * @brief Returns the offset as an address.
+   */
+  MYWR_INLINE address_t offset(std::size_t index) const {
+    return static_cast<address_t>(m_offsets[index]);
+  }
+
+  /**
+   * @brief Reads the current values of remembered slots.
+   *
+   * @return The number of readable slots.
+   */
+  std::size_t read_values() {
+#if defined(MYWR_LINUX)
+    return impl::read_slots(m_slots.data(), m_values.data(), m_slots.size());
+#else
+    std::size_t read = 0;
+    while (read < m_slots.size() && try_read(m_slots[read], m_values[read]))
+      read++;
+    return read;
+#endif
+  }
+
+  /**
+   * @brief Marks the chain as broken.
+   */
+  MYWR_INLINE address broken() {
+    m_resolved = false;
+    return 0;
+  }
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief The begin of the chain.
+   */
+  address_t m_base{};
+
+  /**
+   * @brief The offsets.
+   */
+  std::vector<std::ptrdiff_t> m_offsets;
+
+  /**
+   * @brief Remembered pointers read from @ref m_slots.
+   */
+  std::vector<address_t> m_links;
+
+  /**
+   * @brief Remembered addresses of the links.
+   */
+  std::vector<address_t> m_slots;
+
+  /**
+   * @brief Buffer for the revalidation.
+   */
+  std::vector<address_t> m_values;
+
+  /**
+   * @brief The resolved address.
+   */
+  address_t m_address{};
+
+  /**
+   * @brief Are remembered links valid?
+   */
+  bool m_resolved{};
+
+  /**
+   * @}
+   */
+};
+
+/**
+ * @brief Resolves an address of a value found at runtime, e.g. by a
+ * signature scan. Returns zero if it isn't found (yet).
+ */
+using resolver = address_t (*)(const void* context);
+
+/**
+ * @class basic_view
+ * @brief Typed proxy of a foreign variable resolved once.
+ *
+ * @details
+ * The address is resolved on the first access from a module-relative offset,
+ * a pointer chain, or a @ref resolver, then `Offset` is added. The readability
+ * of the resolved address is checked once and the pointer is cached, so
+ * @ref load is a plain load of the cached pointer. Failed resolutions are
+ * retried on the next access, so views may be created before their modules
+ * are loaded. With `MYWR_DEBUG` defined every @ref load is checked. Not
+ * thread-safe until resolved.
+ *
+ * Use @ref view and @ref field aliases.
+ *
+ * @tparam T      The type of the variable. Must be trivially copyable.
+ * @tparam Offset The offset added to the resolved address.
+ */
+template<typename T, std::ptrdiff_t Offset = 0>
+class basic_view {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "basic_view requires trivially copyable type");
+
+public:
+  /**
+   * @brief Default constructor. Never resolves.
+   */
+  basic_view() = default;
+
+  /**
+   * @brief Constructor on the address of the variable.
+   *
+   * @code{.cpp}
+   * mywr::llmo::view<int> health{0xDEADBEEF};
+   * @endcode
+   */
+  explicit basic_view(const address& target)
+      : m_base(target.value()) {}
+
+  /**
+   * @brief Constructor on the module-relative offset.
+   *
+   * @details
+   * With `chain` the value at `module + offset` is the begin of the pointer
+   * chain: the address is `resolve_chain(module, {offset, chain...})`.
+   *
+   * @code{.cpp}
+   * mywr::llmo::view<int> health{"game.so", 0x1234, {0x10, 0x8}};
+   * @endcode
+   *
+   * @param[in] module The module name, see @ref modules::base.
+   * @param[in] offset The offset from the begin of the module.
+   * @param[in] chain  The rest of the pointer chain.
+   */
+  basic_view(std::string_view                      module,
+             std::ptrdiff_t                        offset,
+             std::initializer_list<std::ptrdiff_t> chain = {})
+      : m_in_module(true)
+      , m_module(module)
+      , m_offsets{offset} {
+    m_offsets.insert(m_offsets.end(), chain);
+  }
+
+  /**
+   * @brief Constructor on the pointer chain, see @ref resolve_chain.
+   */
+  basic_view(const address& base, std::initializer_list<std::ptrdiff_t> chain)
+      : m_base(base.value())
+      , m_offsets(chain) {}
+
+  /**
+   * @brief Constructor on the resolver.
+   *
+   * @code{.cpp}
+   * mywr::llmo::view<int> health{[](const void*) -> mywr::address_t {
+   *   return find_signature("8B 05 ? ? ? ? 85 C0");
+   * }};
+   * @endcode
+   */
+  explicit basic_view(resolver function, const void* context = nullptr)
+      : m_resolver(function)
+      , m_context(context) {}
+
+  /**
+   * @brief Returns the cached pointer, resolves it on the first call.
+   *
+   * @return `nullptr` if the address isn't resolved or readable.
+   */
+  MYWR_INLINE T* get() {
+    if (m_pointer == nullptr)
+      resolve();
+    return m_pointer;
+  }
+
+  /**
+   * @brief Returns `true` if the variable is resolved and readable.
+   */
+  MYWR_INLINE bool valid() {
+    return get() != nullptr;
+  }
+
+  /**
+   * @brief Reads the variable. The view must be @ref valid.
+   *
+   * @details
+   * A plain load of the cached pointer. With `MYWR_DEBUG` defined reads by
+   * @ref try_read and returns `T{}` if the variable is unreadable.
+   */
+  MYWR_INLINE T load() {
+#if defined(MYWR_DEBUG)
+    T value{};
+    if (T* pointer = get())
+      try_read(pointer, value);
+    return value;
+#else
+    return *get();
+#endif
+  }
+
+  /**
+   * @brief Reads the variable atomically. The view must be @ref valid and
+   * the variable aligned.
+   */
+  MYWR_INLINE T load(std::memory_order order) {
+    return as_atomic()->load(order);
+  }
+
+  /**
+   * @brief Reads the variable if the view is valid.
+   */
+  MYWR_INLINE bool try_load(T& out) {
+    T* pointer = get();
+    if (pointer == nullptr)
+      return false;
+
+#if defined(MYWR_DEBUG)
+    return try_read(pointer, out);
+#else
+    out = *pointer;
+    return true;
+#endif
+  }
+
+  /**
+   * @brief Writes the variable. Does nothing if the view isn't valid.
+   *
+   * @details
+   * A plain store if the variable was writable when resolved, otherwise
+   * @ref write unprotecting the memory.
+   */
+  MYWR_INLINE void store(const T& value) {
+    T* pointer = get();
+    if (pointer == nullptr)
+      return;
+
+    if (m_writable)
+      *pointer = value;
+    else
+      write<T>(pointer, value);
+  }
+
+  /**
+   * @brief Writes the variable atomically. The view must be @ref valid, the
+   * variable aligned and writable.
+   */
+  MYWR_INLINE void store(const T& value, std::memory_order order) {
+    as_atomic()->store(value, order);
+  }
+
+  /**
+   * @brief Forgets the resolved address, the next access resolves it again.
+   */
+  MYWR_INLINE void reset() {
+    m_pointer  = nullptr;
+    m_writable = false;
+  }
+
+private:
+  /**
+   * @brief Resolves the address and checks it.
+   */
+  bool resolve() {
+    address_t pointer = m_base;
+    if (m_resolver != nullptr)
+      pointer = m_resolver(m_context);
+    else if (m_in_module)
+      pointer = modules::base(m_module);
+
+    if (pointer == 0)
+      return false;
+
+    if (!m_offsets.empty()) {
+      pointer =
+          impl::follow_chain(pointer, m_offsets.data(), m_offsets.size());
+      if (pointer == 0)
+        return false;
+    }
+    pointer += static_cast<address_t>(Offset);
+
+    byte_t probe[sizeof(T)];
+    if (!try_read(pointer, probe))
+      return false;
+
+    m_writable = (protect::get_protect(pointer) &
+                  protect::memory_prot::kWrite) != 0;
+    m_pointer  = reinterpret_cast<T*>(pointer);
+    return true;
+  }
+
+  /**
+   * @brief Returns the variable as atomic.
+   */
+  MYWR_INLINE std::atomic<T>* as_atomic() {
+    static_assert(sizeof(std::atomic<T>) == sizeof(T) &&
+                      std::atomic<T>::is_always_lock_free,
+                  "atomic access requires lock-free type");
+    return reinterpret_cast<std::atomic<T>*>(get());
+  }
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief The cached pointer.
+   */
+  T* m_pointer{};
+
+  /**
+   * @brief Was the variable writable when resolved?
+   */
+  bool m_writable{};
+
+  /**
+   * @brief The address or the begin of the pointer chain.
+   */
+  address_t m_base{};
+
+  /**
+   * @brief Is @ref m_offsets relative to the module?
+   */
+  bool m_in_module{};
+
+  /**
+   * @brief The module name.
+   */
+  std::string m_module;
+
+  /**
+   * @brief The offsets of the pointer chain.
+   */
+  std::vector<std::ptrdiff_t> m_offsets;
+
+  /**
+   * @brief The resolver.
+   */
+  resolver m_resolver{};
+
+  /**
+   * @brief The context of the resolver.
+   */
+  const void* m_context{};
+
+  /**
+   * @}
+   */
+};
+
+/**
+ * @brief Typed proxy of a foreign variable, see @ref basic_view.
+ *
+ * @code{.cpp}
+ * mywr::llmo::view<int> health{"game.so", 0x1234};
+ * if (health.valid())
+ *   health.store(health.load() + 1);
+ * @endcode
+ */
+template<typename T>
+using view = basic_view<T>;
+
+/**
+ * @brief Typed proxy of a field of a foreign object, see @ref basic_view.
+ *
+ * @code{.cpp}
+ * // player->health, the player pointer is at game.so+0x1234.
+ * mywr::llmo::field<int, 0x48> health{"game.so", 0x1234, {0}};
+ * @endcode
+ */
+template<typename T, std::ptrdiff_t Offset>
+using field = basic_view<T, Offset>;
+
 /**
  * @brief Compares 2 memory areas.
  *
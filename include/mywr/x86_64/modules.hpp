@@ -0,0 +1,310 @@
+/*********************************************************************
+ * @file   modules.hpp
+ * @brief  Module containing loaded modules lookup and module-relative
+ * addresses.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_MODULES_HPP_
+#define MYWR_MODULES_HPP_
+
+namespace mywr {
+/**
+ * @brief Namespace containing loaded modules lookup.
+ *
+ * @details
+ * Modules are identified by their file names (`libc.so.6`, `game.dll`), the
+ * empty name is the main executable. Found bases are cached until
+ * @ref flush_cache, so every module is looked up once.
+ */
+namespace modules {
+namespace impl {
+/**
+ * @brief Cached base of the module.
+ */
+struct cached_module {
+  std::string name;
+  address_t   base{};
+};
+
+/**
+ * @brief Process-wide cache of found modules.
+ */
+struct module_cache {
+  std::mutex                 mutex;
+  std::vector<cached_module> modules;
+};
+
+/**
+ * @brief Returns the process-wide cache. Never destroyed, so lookups from
+ * static destructors are safe.
+ */
+inline module_cache& get_cache() {
+  static module_cache* instance = new module_cache{};
+  return *instance;
+}
+
+/**
+ * @brief Finds bases of the modules not cached yet, by one traversal of the
+ * address space on Linux.
+ *
+ * @param[in]  names The module names.
+ * @param[out] bases The bases, zero for modules not loaded.
+ * @param[in]  count The number of modules.
+ */
+inline void find_bases(const std::string_view* names,
+                       address_t*              bases,
+                       std::size_t             count) {
+#if defined(MYWR_WINDOWS)
+  for (std::size_t i = 0; i < count; i++) {
+    std::string terminated{names[i]};
+    bases[i] = reinterpret_cast<address_t>(
+        GetModuleHandleA(names[i].empty() ? nullptr : terminated.c_str()));
+  }
+#elif defined(MYWR_LINUX)
+  std::error_code error;
+  std::string     executable =
+      std::filesystem::read_symlink("/proc/self/exe", error).native();
+
+  std::size_t found = 0;
+  for (std::size_t i = 0; i < count; i++)
+    bases[i] = 0;
+
+  // The lowest mapping of the file is the begin of the module.
+  procfs::for_each_region(
+      [&](const procfs::memory_region& region) {
+        if (region.pathname.empty())
+          return true;
+
+        std::string_view filename = region.pathname;
+        auto             slash    = filename.rfind('/');
+        if (slash != std::string_view::npos)
+          filename.remove_prefix(slash + 1);
+
+        for (std::size_t i = 0; i < count; i++) {
+          if (bases[i] != 0)
+            continue;
+
+          bool match = names[i].empty() ? region.pathname == executable
+                                        : filename == names[i];
+          if (match) {
+            bases[i] = region.begin;
+            found++;
+          }
+        }
+        return found != count;
+      },
+      true);
+#else
+  for (std::size_t i = 0; i < count; i++)
+    bases[i] = 0;
+  static_cast<void>(names);
+#endif
+}
+
+/**
+ * @brief Returns the cached base of the module or zero.
+ */
+inline address_t find_cached(module_cache& cache, std::string_view name) {
+  for (const auto& module : cache.modules)
+    if (module.name == name)
+      return module.base;
+  return 0;
+}
+} // namespace impl
+
+/**
+ * @brief Returns the bases of the loaded modules.
+ *
+ * @details
+ * Modules missing in the cache are looked up together, so resolving many
+ * modules costs one traversal of the address space.
+ *
+ * @param[in]  names The module names.
+ * @param[out] out   The bases, zero for modules not loaded.
+ * @param[in]  count The number of modules.
+ */
+inline void
+    bases(const std::string_view* names, address_t* out, std::size_t count) {
+  auto&                       cache = impl::get_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  std::vector<std::string_view> missing;
+  for (std::size_t i = 0; i < count; i++) {
+    out[i] = impl::find_cached(cache, names[i]);
+    if (out[i] == 0 &&
+        std::find(missing.begin(), missing.end(), names[i]) == missing.end())
+      missing.push_back(names[i]);
+  }
+
+  if (missing.empty())
+    return;
+
+  std::vector<address_t> found(missing.size());
+  impl::find_bases(missing.data(), found.data(), missing.size());
+
+  for (std::size_t i = 0; i < missing.size(); i++)
+    if (found[i] != 0)
+      cache.modules.push_back({std::string{missing[i]}, found[i]});
+
+  for (std::size_t i = 0; i < count; i++)
+    if (out[i] == 0)
+      out[i] = impl::find_cached(cache, names[i]);
+}
+
+/**
+ * @brief Returns the base of the loaded module.
+ *
+ * @code{.cpp}
+ * auto libc = mywr::modules::base("libc.so.6");
+ * @endcode
+ *
+ * @param[in] name The module name, the main executable if empty.
+ *
+ * @return The base of the module or zero if it isn't loaded.
+ */
+inline address_t base(std::string_view name) {
+  address_t result{};
+  bases(&name, &result, 1);
+  return result;
+}
+
+/**
+ * @brief Forgets cached bases. Call it after modules were unloaded.
+ */
+inline void flush_cache() {
+  auto&                       cache = impl::get_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  cache.modules.clear();
+}
+} // namespace modules
+
+/**
+ * @class module_address
+ * @brief Address relative to the begin of a module.
+ *
+ * @details
+ * Stores the module name and the relative virtual address (RVA). Resolves to
+ * the absolute address on the first use and caches it. The constructor is
+ * `constexpr`, so static tables are constant-initialized and may be resolved
+ * in bulk by @ref resolve_all. The module name must outlive the object,
+ * string literals do. Not thread-safe until resolved.
+ *
+ * @code{.cpp}
+ * static mywr::module_address offsets[] = {
+ *   {"game.so", 0x1234},
+ *   {"game.so", 0x5678},
+ *   {"libc.so.6", 0x9ABC},
+ * };
+ * mywr::module_address::resolve_all(offsets, std::size(offsets));
+ *
+ * mywr::llmo::write<int>(offsets[0].resolve(), 100);
+ * @endcode
+ */
+class module_address {
+public:
+  /**
+   * @brief Main constructor.
+   *
+   * @param[in] module The module name, the main executable if empty.
+   * @param[in] rva    The offset from the begin of the module.
+   */
+  constexpr module_address(std::string_view module, address_t rva)
+      : m_module(module)
+      , m_rva(rva) {}
+
+  /**
+   * @brief Returns the module name.
+   */
+  MYWR_INLINE constexpr std::string_view module() const {
+    return m_module;
+  }
+
+  /**
+   * @brief Returns the offset from the begin of the module.
+   */
+  MYWR_INLINE constexpr address_t rva() const {
+    return m_rva;
+  }
+
+  /**
+   * @brief Returns the absolute address, resolves it on the first call.
+   *
+   * @return The address or zero if the module isn't loaded.
+   */
+  MYWR_INLINE address resolve() {
+    if (m_address == 0)
+      set_base(modules::base(m_module));
+    return m_address;
+  }
+
+  /**
+   * @brief Returns `true` if the address is resolved.
+   */
+  MYWR_INLINE constexpr bool resolved() const {
+    return m_address != 0;
+  }
+
+  /**
+   * @brief Resolves the table, looking up every module once.
+   *
+   * @param[in] table The table.
+   * @param[in] count The number of entries.
+   *
+   * @return The number of resolved entries.
+   */
+  static std::size_t resolve_all(module_address* table, std::size_t count) {
+    std::vector<std::string_view> names(count);
+    std::vector<address_t>        bases(count);
+    for (std::size_t i = 0; i < count; i++)
+      names[i] = table[i].m_module;
+
+    modules::bases(names.data(), bases.data(), count);
+
+    std::size_t resolved = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      table[i].set_base(bases[i]);
+      resolved += table[i].resolved();
+    }
+    return resolved;
+  }
+
+private:
+  /**
+   * @brief Resolves the address by the module base.
+   */
+  MYWR_INLINE void set_base(address_t base) {
+    if (base != 0)
+      m_address = base + m_rva;
+  }
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief The module name.
+   */
+  std::string_view m_module;
+
+  /**
+   * @brief The offset from the begin of the module.
+   */
+  address_t m_rva{};
+
+  /**
+   * @brief The resolved address.
+   */
+  address_t m_address{};
+
+  /**
+   * @}
+   */
+};
+} // namespace mywr
+
+#endif // !MYWR_MODULES_HPP_
@@ -157,20 +157,329 @@ struct memory_region {
   path_type pathtype{kUnknown};
 };
 
+#if defined(MYWR_UNIX)
+namespace impl {
+/**
+ * @brief The number of `fork()` calls the process went through, bumped in
+ * the child.
+ */
+inline std::atomic<std::uint32_t> g_fork_generation{0};
+
+/**
+ * @brief Returns the fork generation of the process.
+ *
+ * @details
+ * Descriptors of /proc/self files refer to the process which opened them, in
+ * a forked child they still read and write the parent. Cached descriptors
+ * remember the generation they were opened in and reopen when it changes.
+ */
+inline std::uint32_t fork_generation() {
+  static const bool registered = pthread_atfork(nullptr, nullptr, [] {
+    g_fork_generation.fetch_add(1, std::memory_order_relaxed);
+  }) == 0;
+  (void)registered;
+
+  return g_fork_generation.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Process-wide descriptor of a /proc/self file shared between threads.
+ *
+ * @details
+ * Opened on the first use and reopened on the first use in a forked child.
+ * Only for positional I/O and ioctls, which don't depend on the shared file
+ * position.
+ */
+class process_descriptor {
+public:
+  /**
+   * @brief Constructor on path, the file is opened on first @ref get().
+   *
+   * @param[in] path  Path to the file, must outlive the object.
+   * @param[in] flags Flags of `open`, `O_CLOEXEC` is added.
+   */
+  process_descriptor(const char* path, int flags)
+      : m_path(path)
+      , m_flags(flags | O_CLOEXEC) {}
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  process_descriptor(const process_descriptor&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const process_descriptor&) = delete;
+
+  /**
+   * @brief Returns the descriptor opened by this process or -1 if the file
+   * can't be opened.
+   */
+  int get() {
+    std::uint32_t generation = fork_generation();
+    if (m_generation.load(std::memory_order_acquire) != generation + 1)
+      reopen(generation);
+    return m_fd.load(std::memory_order_relaxed);
+  }
+
+private:
+  void reopen(std::uint32_t generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_generation.load(std::memory_order_relaxed) == generation + 1)
+      return;
+
+    // Once per process, not counted as the syscall of the caller.
+    int previous = m_fd.exchange(::open(m_path, m_flags));
+    if (previous >= 0)
+      ::close(previous);
+
+    // Zero means never opened.
+    m_generation.store(generation + 1, std::memory_order_release);
+  }
+
+  const char*                m_path;
+  int                        m_flags;
+  std::atomic<int>           m_fd{-1};
+  std::atomic<std::uint32_t> m_generation{0};
+  std::mutex                 m_mutex{};
+};
+} // namespace impl
+#endif
+
+/**
+ * @brief Persistent reader of the procfs file.
+ *
+ * @details
+ * Keeps the file descriptor open and re-reads the whole file with `pread` from
+ * offset 0 into the growable buffer which is reused between reads. After the
+ * buffer has grown to the size of the file, each @ref source::read() costs
+ * one or a few syscalls and no allocations. The file is reopened when read in
+ * a forked child, so /proc/self always refers to the reading process.
+ *
+ * @code{.cpp}
+ * static thread_local mywr::procfs::source maps{"/proc/self/maps"};
+ *
+ * std::vector<mywr::procfs::memory_region> regions;
+ * mywr::procfs::parse_maps(maps, regions);
+ * @endcode
+ */
+class source {
+public:
+  /**
+   * @name Constructors & Destructor.
+   * @{
+   */
+
+  /**
+   * @brief Default constructor forbidden.
+   */
+  source() = delete;
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  source(const source&) = delete;
+
+  /**
+   * @brief Move constructor forbidden.
+   */
+  source(source&&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const source&) = delete;
+
+  /**
+   * @brief Move operator forbidden.
+   */
+  void operator=(source&&) = delete;
+
+  /**
+   * @brief Constructor on path. Opens the file.
+   *
+   * @param[in] path     Path to the file.
+   * @param[in] capacity Initial capacity of the buffer.
+   */
+  explicit source(std::string_view path, std::size_t capacity = 4096)
+      : m_path(path)
+      , m_buffer(capacity ? capacity : 1) {
+#if defined(MYWR_UNIX)
+    m_generation = impl::fork_generation();
+    MYWR_STATS_COUNT(kSyscall);
+    m_fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+  }
+
+  /**
+   * @brief Destructor. Closes the file.
+   */
+  ~source() {
+#if defined(MYWR_UNIX)
+    if (m_fd >= 0)
+      ::close(m_fd);
+#endif
+  }
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Public Member Functions
+   * @{
+   */
+
+  /**
+   * @brief Indicates whether the file was opened.
+   */
+  MYWR_INLINE bool good() const {
+    return m_fd >= 0;
+  }
+
+  /**
+   * @brief Re-reads the whole file from the begin.
+   *
+   * @return View of the file contents, valid until the next read. Empty if
+   * reading failed.
+   */
+  std::string_view read() {
+    m_size = 0;
+
+#if defined(MYWR_UNIX)
+    if (m_generation != impl::fork_generation())
+      reopen();
+
+    if (m_fd < 0)
+      return {};
+
+    for (;;) {
+      if (m_size == m_buffer.size())
+        m_buffer.resize(m_buffer.size() * 2);
+
+      MYWR_STATS_COUNT(kSyscall);
+      ssize_t count = pread(m_fd,
+                            m_buffer.data() + m_size,
+                            m_buffer.size() - m_size,
+                            static_cast<off_t>(m_size));
+      if (count < 0) {
+        if (errno == EINTR)
+          continue;
+
+        m_size = 0;
+        break;
+      }
+
+      if (count == 0)
+        break;
+
+      m_size += static_cast<std::size_t>(count);
+    }
+#endif
+
+    return data();
+  }
+
+  /**
+   * @brief Returns contents of the last read.
+   */
+  MYWR_INLINE std::string_view data() const {
+    return {m_buffer.data(), m_size};
+  }
+
+  /**
+   * @brief Returns the file descriptor.
+   */
+  MYWR_INLINE int descriptor() const {
+    return m_fd;
+  }
+
+  /**
+   * @}
+   */
+
+private:
+#if defined(MYWR_UNIX)
+  /**
+   * @brief Reopens the file in the forked child.
+   */
+  void reopen() {
+    if (m_fd >= 0)
+      ::close(m_fd);
+
+    m_generation = impl::fork_generation();
+    MYWR_STATS_COUNT(kSyscall);
+    m_fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+  }
+#endif
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief The path to the file.
+   */
+  std::string m_path{};
+
+  /**
+   * @brief The file descriptor.
+   */
+  int m_fd{-1};
+
+  /**
+   * @brief The fork generation the file was opened in.
+   */
+  std::uint32_t m_generation{};
+
+  /**
+   * @brief Reused buffer with file contents.
+   */
+  std::vector<char> m_buffer{};
+
+  /**
+   * @brief The size of the file contents in the buffer.
+   */
+  std::size_t m_size{};
+
+  /**
+   * @}
+   */
+};
+
 /**
  * @brief A simple class for writing your own procfs file parsers.
  */
 class parser {
 public:
   /**
-   * @brief Constructor on path. Opens the file on the passed path and reads
+   * @brief Constructor on path. Reads the file on the passed path and the
    * first line.
+   *
+   * @details
+   * Opens the file on each construction. Use @ref source to parse the same file
+   * repeatedly.
    */
-  parser(std::string_view path) {
+  parser(std::string_view path)
+      : m_source(std::make_unique<source>(path)) {
+    m_data = m_source->read();
+    m_fail = m_data.empty();
+
     /**
-     * Open the file.
+     * Read first line.
      */
-    m_file.open(path.data());
+    next_line();
+  }
+
+  /**
+   * @brief Constructor on persistent source. Re-reads the source and reads the
+   * first line.
+   */
+  parser(source& file)
+      : m_data(file.read()) {
+    m_fail = m_data.empty();
 
     /**
      * Read first line.
@@ -178,12 +487,30 @@ public:
     next_line();
   }
 
+  /**
+   * @brief Constructor on in-memory buffer. The buffer must outlive the
+   * parser. Doesn't allocate.
+   *
+   * @code{.cpp}
+   * std::string_view text = "7f0000000000-7f0000001000 r--p ...";
+   *
+   * mywr::procfs::parser parser{text.data(), text.size()};
+   * @endcode
+   */
+  parser(const char* data, std::size_t size)
+      : m_data(data, size) {
+    /**
+     * Read first line.
+     */
+    next_line();
+  }
+
   /**
    * @brief Indicates whether the end of the file has been reached.
    * @return True if file ended or fail opening failed.
    */
   bool eof() const {
-    return m_file.eof() || fail();
+    return m_eof || fail();
   }
 
   /**
@@ -197,7 +524,7 @@ public:
    * @brief Indicates wherther the file opening failed.
    */
   bool fail() const {
-    return m_file.fail();
+    return m_fail;
   }
 
   /**
@@ -265,46 +592,99 @@ public:
    *
    * @param[in] value The variable to write the result to.
    * @param[in] radix The system of calculation of number.
+   *
+   * @return `true` if the capture area starts with a number.
    */
   template<typename T,
            typename = std::enable_if_t<
                std::is_integral_v<T> || std::is_floating_point_v<T> ||
                    std::is_same_v<T, double> || std::is_same_v<T, long double>,
                T>>
-  void grab_number(T& value, int radix = 10) {
-    std::from_chars(&m_line[m_scope], &m_line[m_cursor], value, radix);
+  bool grab_number(T& value, int radix = 10) {
+    return std::from_chars(m_line.data() + m_scope,
+                           m_line.data() + m_cursor,
+                           value,
+                           radix)
+               .ec == std::errc{};
   }
 
   /**
    * @brief Returns a string of characters received from the capture area.
    */
   std::string grab_string() {
+    return std::string{grab_view()};
+  }
+
+  /**
+   * @brief Returns a view of characters received from the capture area. The
+   * view is valid until the next line is read.
+   */
+  std::string_view grab_view() const {
     return m_line.substr(m_scope, m_cursor - m_scope);
   }
 
+  /**
+   * @brief Returns a view of the whole current line.
+   */
+  std::string_view line() const {
+    return m_line;
+  }
+
+  /**
+   * @brief Returns the offset of the current line from the begin of the
+   * buffer.
+   */
+  std::size_t offset() const {
+    return m_line_offset;
+  }
+
+  /**
+   * @brief Moves to the line starting at the specified offset of the buffer.
+   *
+   * @details
+   * Used for fast paths over files with fixed layout: remember the @ref
+   * offset() of the interesting line and seek directly to it next time.
+   */
+  void seek(std::size_t offset) {
+    m_offset = offset;
+    m_eof    = false;
+    next_line();
+  }
+
   /**
    * @brief Returns the current character without moving the reading cursor.
    */
   char now() const {
-    return m_line[m_cursor];
+    return eol() ? '\0' : m_line[m_cursor];
   }
 
   /**
    * @brief Returns the current character, and then moves the reading cursor..
    */
   char next() {
-    return m_line[m_cursor++];
+    return eol() ? '\0' : m_line[m_cursor++];
   }
 
   /**
    * @brief Moves to the next line.
    */
   void next_line() {
-    if (!fail())
-      std::getline(m_file, m_line);
-
     m_scope  = 0;
     m_cursor = 0;
+
+    if (m_offset >= m_data.size()) {
+      m_eof  = true;
+      m_line = {};
+      return;
+    }
+
+    std::size_t end = m_data.find('\n', m_offset);
+    if (end == std::string_view::npos)
+      end = m_data.size();
+
+    m_line        = m_data.substr(m_offset, end - m_offset);
+    m_line_offset = m_offset;
+    m_offset      = end + 1;
   }
 
 #if defined(MYWR_FEATURE_PROCFS_PARSER_DUMP)
@@ -313,7 +693,7 @@ public:
    * the end of the line.
    */
   void dump_from_cursor() {
-    std::cout << m_line.substr(m_cursor, m_line.size() - m_cursor) << '\n';
+    std::cout << m_line.substr(m_cursor) << '\n';
   }
 
   /**
@@ -326,14 +706,39 @@ public:
 
 private:
   /**
-   * @brief Current file we parsing.
+   * @brief The source owned by the parser constructed on path.
+   */
+  std::unique_ptr<source> m_source{};
+
+  /**
+   * @brief In-memory buffer we parsing.
    */
-  std::ifstream m_file{};
+  std::string_view m_data{};
+
+  /**
+   * @brief Offset of the next line in the in-memory buffer.
+   */
+  std::size_t m_offset{};
+
+  /**
+   * @brief Offset of the current line in the in-memory buffer.
+   */
+  std::size_t m_line_offset{};
+
+  /**
+   * @brief Is the buffer ended?
+   */
+  bool m_eof{};
+
+  /**
+   * @brief Did reading of the file fail?
+   */
+  bool m_fail{};
 
   /**
    * @brief Current line we parsing.
    */
-  std::string m_line{};
+  std::string_view m_line{};
 
   /**
    * @brief Capture area start.
@@ -347,19 +752,26 @@ private:
 };
 
 /**
- * @brief Parses the /proc/self/maps file to get information about mapped memory
- * regions.
+ * @brief Parses the contents of the maps file to get information about mapped
+ * memory regions.
+ *
+ * @code{.cpp}
+ * std::string_view text = load_recorded_maps();
  *
+ * mywr::procfs::parser parser{text.data(), text.size()};
+ * mywr::procfs::parse_maps(parser, regions);
+ * @endcode
+ *
+ * @param[in]  parser  Parser over the contents of the maps file.
  * @param[out] regions A dynamic array of regions where the parser will add new
  * entries.
  */
-static void parse_maps(std::vector<memory_region>& regions) {
+static void parse_maps(parser& parser, std::vector<memory_region>& regions) {
+  MYWR_STATS_TIMER(kParseMaps);
+  MYWR_TRACE_SCOPE("procfs::parse_maps", 0);
+
 #if defined(MYWR_UNIX)
-  #if defined(__FreeBSD__)
-  constexpr auto kProcMapsPath = "/proc/curproc/map";
-  #else
-  constexpr auto kProcMapsPath = "/proc/self/maps";
-  #endif
+  #if defined(MYWR_FEATURE_PROCFS_PATHTYPE_DEDUCTION)
   constexpr auto kVdso        = "[vdso]";
   constexpr auto kVvar        = "[vvar]";
   constexpr auto kStack       = "[stack]";
@@ -367,8 +779,7 @@ static void parse_maps(std::vector<memory_region>& regions) {
   constexpr auto kAnon        = "[anon:";
   constexpr auto kAnonShmem   = "[anon_shmem:";
   constexpr auto kHeap        = "[heap]";
-
-  parser parser{kProcMapsPath};
+  #endif
 
   while (!parser.eof()) {
     memory_region region{};
@@ -431,12 +842,12 @@ static void parse_maps(std::vector<memory_region>& regions) {
      */
     parser.scope();
     parser.next_until(':');
-    parser.grab_number(region.dev_major);
+    parser.grab_number(region.dev_major, 16);
     parser.next();
 
     parser.scope();
     parser.next_until_space();
-    parser.grab_number(region.dev_minor);
+    parser.grab_number(region.dev_minor, 16);
     parser.next();
 
     /**
@@ -482,6 +893,704 @@ static void parse_maps(std::vector<memory_region>& regions) {
   }
 #endif
 }
+
+/**
+ * @brief Re-reads the persistent maps source and parses it.
+ *
+ * @param[in]  maps    Persistent source of the maps file.
+ * @param[out] regions A dynamic array of regions where the parser will add new
+ * entries.
+ */
+static void parse_maps(source& maps, std::vector<memory_region>& regions) {
+  parser parser{maps};
+  parse_maps(parser, regions);
+}
+
+/**
+ * @brief Parses the /proc/self/maps file to get information about mapped memory
+ * regions.
+ *
+ * @details
+ * The file is kept open per thread, so each call costs only re-reading it.
+ *
+ * @param[out] regions A dynamic array of regions where the parser will add new
+ * entries.
+ */
+static void parse_maps(std::vector<memory_region>& regions) {
+#if defined(MYWR_UNIX)
+  #if defined(__FreeBSD__)
+  constexpr auto kProcMapsPath = "/proc/curproc/map";
+  #else
+  constexpr auto kProcMapsPath = "/proc/self/maps";
+  #endif
+
+  static thread_local source maps{kProcMapsPath, 64 * 1024};
+  parse_maps(maps, regions);
+#endif
+}
+
+#if defined(MYWR_LINUX)
+namespace impl {
+/**
+ * @brief Request of `PROCMAP_QUERY` ioctl (Linux 6.11+), mirrors
+ * `struct procmap_query` from `linux/fs.h`.
+ */
+struct procmap_query {
+  std::uint64_t size;
+  std::uint64_t query_flags;
+  std::uint64_t query_addr;
+  std::uint64_t vma_start;
+  std::uint64_t vma_end;
+  std::uint64_t vma_flags;
+  std::uint64_t vma_page_size;
+  std::uint64_t vma_offset;
+  std::uint64_t inode;
+  std::uint32_t dev_major;
+  std::uint32_t dev_minor;
+  std::uint32_t vma_name_size;
+  std::uint32_t build_id_size;
+  std::uint64_t vma_name_addr;
+  std::uint64_t build_id_addr;
+};
+
+constexpr std::uint64_t kProcmapQueryReadable       = 0x01;
+constexpr std::uint64_t kProcmapQueryWritable       = 0x02;
+constexpr std::uint64_t kProcmapQueryExecutable     = 0x04;
+constexpr std::uint64_t kProcmapQueryShared         = 0x08;
+constexpr std::uint64_t kProcmapQueryCoveringOrNext = 0x10;
+constexpr unsigned long kProcmapQuery = _IOWR('f', 17, procmap_query);
+
+/**
+ * @brief Support state of `PROCMAP_QUERY`: -1 unknown, 0 no, 1 yes.
+ */
+inline std::atomic<int> g_procmap_query_state{-1};
+
+/**
+ * @brief Returns the process-wide descriptor of /proc/self/maps used for
+ * ioctls, reopened in forked children.
+ */
+inline int procmap_descriptor() {
+  static process_descriptor maps{"/proc/self/maps", O_RDONLY};
+  return maps.get();
+}
+
+/**
+ * @brief Performs `PROCMAP_QUERY` and converts the result.
+ *
+ * @return 1 if found, 0 if there is no such region, -1 if the ioctl is not
+ * supported.
+ */
+inline int procmap_query_region(std::uint64_t  address,
+                                std::uint64_t  flags,
+                                memory_region& region,
+                                bool           with_pathname) {
+  if (g_procmap_query_state.load(std::memory_order_relaxed) == 0)
+    return -1;
+
+  int fd = procmap_descriptor();
+  if (fd < 0) {
+    g_procmap_query_state.store(0, std::memory_order_relaxed);
+    return -1;
+  }
+
+  static thread_local char name[4096];
+
+  procmap_query query{};
+  query.size        = sizeof(query);
+  query.query_flags = flags;
+  query.query_addr  = address;
+  if (with_pathname) {
+    query.vma_name_addr = reinterpret_cast<std::uintptr_t>(name);
+    query.vma_name_size = sizeof(name);
+  }
+
+  MYWR_STATS_COUNT(kSyscall);
+  if (ioctl(fd, kProcmapQuery, &query) != 0) {
+    if (errno == ENOENT)
+      return 0;
+
+    /**
+     * Old kernels answer with ENOTTY (or EINVAL for unknown ioctl).
+     */
+    if (errno == ENOTTY || errno == EINVAL || errno == EOPNOTSUPP)
+      g_procmap_query_state.store(0, std::memory_order_relaxed);
+    return -1;
+  }
+  g_procmap_query_state.store(1, std::memory_order_relaxed);
+
+  region.begin       = static_cast<std::uintptr_t>(query.vma_start);
+  region.end         = static_cast<std::uintptr_t>(query.vma_end);
+  region.permissions = 0;
+  if (query.vma_flags & kProcmapQueryReadable)
+    region.permissions |= PROT_READ;
+  if (query.vma_flags & kProcmapQueryWritable)
+    region.permissions |= PROT_WRITE;
+  if (query.vma_flags & kProcmapQueryExecutable)
+    region.permissions |= PROT_EXEC;
+
+  region.is_shared  = (query.vma_flags & kProcmapQueryShared) != 0;
+  region.is_private = !region.is_shared;
+  region.offset     = static_cast<std::size_t>(query.vma_offset);
+  region.dev_major  = query.dev_major;
+  region.dev_minor  = query.dev_minor;
+  region.inode      = query.inode;
+
+  if (with_pathname && query.vma_name_size > 0)
+    region.pathname.assign(name, query.vma_name_size - 1);
+  else
+    region.pathname.clear();
+  return 1;
+}
+} // namespace impl
+#endif
+
+/**
+ * @brief Returns `true` if the kernel supports binary `PROCMAP_QUERY` lookups.
+ * Detected at runtime by the first query.
+ */
+static bool procmap_query_available() {
+#if defined(MYWR_LINUX)
+  if (impl::g_procmap_query_state.load(std::memory_order_relaxed) < 0) {
+    memory_region region{};
+    impl::procmap_query_region(
+        reinterpret_cast<std::uintptr_t>(&region), 0, region, false);
+  }
+  return impl::g_procmap_query_state.load(std::memory_order_relaxed) == 1;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Finds the memory region containing the address by parsing the whole
+ * maps file.
+ *
+ * @param[in]  address The address to look for.
+ * @param[out] region  The region containing the address.
+ *
+ * @return `true` if the region was found.
+ */
+static bool find_region(std::uintptr_t address, memory_region& region) {
+  static thread_local std::vector<memory_region> regions;
+
+  regions.clear();
+  parse_maps(regions);
+
+  for (auto& entry : regions) {
+    if (address >= entry.begin && address < entry.end) {
+      region = std::move(entry);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Looks up the memory region containing the address.
+ *
+ * @details
+ * Uses binary `PROCMAP_QUERY` ioctl on kernels supporting it (one syscall, no
+ * text parsing), otherwise falls back to @ref find_region.
+ *
+ * @code{.cpp}
+ * mywr::procfs::memory_region region;
+ * if (mywr::procfs::query_region(0xDEADBEEF, region))
+ *   printf("%zx-%zx\n", region.begin, region.end);
+ * @endcode
+ *
+ * @param[in]  address       The address to look for.
+ * @param[out] region        The region containing the address.
+ * @param[in]  with_pathname Fill @ref memory_region::pathname too.
+ *
+ * @return `true` if the region was found.
+ */
+static bool query_region(std::uintptr_t address,
+                         memory_region& region,
+                         bool           with_pathname = false) {
+  MYWR_STATS_TIMER(kQueryRegion);
+
+#if defined(MYWR_LINUX)
+  int result = impl::procmap_query_region(address, 0, region, with_pathname);
+  if (result >= 0)
+    return result == 1;
+#endif
+  return find_region(address, region);
+}
+
+/**
+ * @brief Calls `callback` for each mapped memory region in address order.
+ *
+ * @details
+ * Uses `PROCMAP_QUERY` ioctl when available, otherwise parses the maps file.
+ * The callback may return `bool`, `false` stops the iteration.
+ *
+ * @code{.cpp}
+ * mywr::procfs::for_each_region([](const mywr::procfs::memory_region& region) {
+ *   return region.end - region.begin < (1u << 30);
+ * });
+ * @endcode
+ *
+ * @param[in] callback      Callable taking `const memory_region&`.
+ * @param[in] with_pathname Fill @ref memory_region::pathname too.
+ */
+template<typename Fn>
+static void for_each_region(Fn&& callback, bool with_pathname = false) {
+  auto invoke = [&callback](const memory_region& region) {
+    if constexpr (std::is_same_v<decltype(callback(region)), bool>)
+      return callback(region);
+    else
+      return callback(region), true;
+  };
+
+#if defined(MYWR_LINUX)
+  if (procmap_query_available()) {
+    memory_region region{};
+    std::uint64_t address = 0;
+
+    while (impl::procmap_query_region(address,
+                                      impl::kProcmapQueryCoveringOrNext,
+                                      region,
+                                      with_pathname) == 1) {
+      if (!invoke(region))
+        return;
+
+      address = region.end;
+    }
+    return;
+  }
+#endif
+
+  std::vector<memory_region> regions;
+  parse_maps(regions);
+
+  for (const auto& region : regions)
+    if (!invoke(region))
+      return;
+}
+
+/**
+ * @brief Data-structure for the health-related fields of /proc/self/status.
+ */
+struct process_status {
+  /**
+   * @brief Peak virtual memory size in bytes (`VmPeak`).
+   */
+  std::size_t vm_peak{};
+
+  /**
+   * @brief Virtual memory size in bytes (`VmSize`).
+   */
+  std::size_t vm_size{};
+
+  /**
+   * @brief Peak resident set size in bytes (`VmHWM`).
+   */
+  std::size_t vm_hwm{};
+
+  /**
+   * @brief Resident set size in bytes (`VmRSS`).
+   */
+  std::size_t vm_rss{};
+
+  /**
+   * @brief Number of threads in the process (`Threads`).
+   */
+  std::uint32_t threads{};
+
+  /**
+   * @brief Number of voluntary context switches.
+   */
+  std::uint64_t voluntary_ctxt_switches{};
+
+  /**
+   * @brief Number of involuntary context switches.
+   */
+  std::uint64_t nonvoluntary_ctxt_switches{};
+};
+
+/**
+ * @brief Data-structure for the health-related fields of /proc/self/stat.
+ */
+struct process_stat {
+  /**
+   * @brief Process state (R, S, D, Z, T, ...).
+   */
+  char state{};
+
+  /**
+   * @brief Number of minor faults.
+   */
+  std::uint64_t minflt{};
+
+  /**
+   * @brief Number of major faults.
+   */
+  std::uint64_t majflt{};
+
+  /**
+   * @brief Time spent in user mode in clock ticks.
+   */
+  std::uint64_t utime{};
+
+  /**
+   * @brief Time spent in kernel mode in clock ticks.
+   */
+  std::uint64_t stime{};
+
+  /**
+   * @brief Number of threads in the process.
+   */
+  std::uint32_t num_threads{};
+
+  /**
+   * @brief Virtual memory size in bytes.
+   */
+  std::size_t vsize{};
+
+  /**
+   * @brief Resident set size in pages.
+   */
+  std::size_t rss{};
+};
+
+/**
+ * @brief Reads /proc/self/status.
+ *
+ * @details
+ * Designed to be polled frequently: the file is kept open per thread and
+ * re-read by @ref source, nothing is allocated per call. Layout of the
+ * file is the same between reads, so offsets of the interesting lines are
+ * remembered and checked first; the full scan is done only if the layout
+ * changed.
+ *
+ * @code{.cpp}
+ * mywr::procfs::process_status status;
+ * if (mywr::procfs::status(status))
+ *   report_rss(status.vm_rss);
+ * @endcode
+ *
+ * @param[out] out Parsed fields.
+ *
+ * @return Success of reading.
+ */
+inline bool status(process_status& out) {
+#if defined(MYWR_LINUX)
+  struct entry {
+    std::string_view         key;
+    std::atomic<std::size_t> offset;
+  };
+
+  static thread_local source file{"/proc/self/status", 8192};
+  static entry               entries[]{
+      {"VmPeak",                     {0}},
+      {"VmSize",                     {0}},
+      {"VmHWM",                      {0}},
+      {"VmRSS",                      {0}},
+      {"Threads",                    {0}},
+      {"voluntary_ctxt_switches",    {0}},
+      {"nonvoluntary_ctxt_switches", {0}},
+  };
+
+  parser parser{file};
+  if (parser.fail())
+    return false;
+
+  /**
+   * Parses the value of current line if its key is `key`.
+   */
+  auto grab_field = [&parser](std::string_view key, std::uint64_t& value) {
+    parser.scope();
+    parser.next_until(':');
+    if (parser.grab_view() != key)
+      return false;
+
+    parser.next();
+    parser.next_until_any_char();
+    parser.scope();
+    parser.next_until_space();
+    parser.grab_number(value);
+    return true;
+  };
+
+  bool          found_all = true;
+  std::uint64_t values[std::size(entries)]{};
+
+  for (std::size_t i = 0; i < std::size(entries); ++i) {
+    entry& entry = entries[i];
+
+    /**
+     * Fast path: the line is at the remembered offset.
+     */
+    parser.seek(entry.offset.load(std::memory_order_relaxed));
+    bool found = !parser.eof() && grab_field(entry.key, values[i]);
+
+    /**
+     * Slow path: scan the file from the begin and remember the offset.
+     */
+    if (!found) {
+      parser.seek(0);
+      while (!parser.eof() && !(found = grab_field(entry.key, values[i])))
+        parser.next_line();
+
+      if (found)
+        entry.offset.store(parser.offset(), std::memory_order_relaxed);
+    }
+
+    found_all &= found;
+  }
+
+  /**
+   * Memory sizes are reported in kB.
+   */
+  out.vm_peak                    = static_cast<std::size_t>(values[0] * 1024);
+  out.vm_size                    = static_cast<std::size_t>(values[1] * 1024);
+  out.vm_hwm                     = static_cast<std::size_t>(values[2] * 1024);
+  out.vm_rss                     = static_cast<std::size_t>(values[3] * 1024);
+  out.threads                    = static_cast<std::uint32_t>(values[4]);
+  out.voluntary_ctxt_switches    = values[5];
+  out.nonvoluntary_ctxt_switches = values[6];
+
+  return found_all;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Parses the contents of /proc/self/stat.
+ *
+ * @details
+ * Fields are positional, so after skipping the command name (it may contain
+ * spaces and parentheses) the parser jumps directly between the fields.
+ *
+ * @param[in]  parser Parser over the contents of the stat file.
+ * @param[out] out    Parsed fields.
+ *
+ * @return `true` if every field was parsed.
+ */
+inline bool parse_stat(parser& parser, process_stat& out) {
+  std::size_t comm_end = parser.line().rfind(')');
+  if (comm_end == std::string_view::npos)
+    return false;
+
+  /**
+   * Skip "pid (comm) ", the state is the third field.
+   */
+  parser.next_for(comm_end + 2);
+  out.state = parser.next();
+
+  /**
+   * Moves to the field with specified number (1-based, as in proc(5)). On
+   * truncated input the capture area stays empty and no number is grabbed.
+   */
+  std::size_t current = 3;
+  auto        skip_to = [&](std::size_t number) {
+    for (; current < number; ++current) {
+      parser.next_until_space();
+      parser.next();
+    }
+    parser.scope();
+    parser.next_until_space();
+  };
+
+  bool parsed = out.state != '\0';
+
+  skip_to(10);
+  parsed &= parser.grab_number(out.minflt);
+  skip_to(12);
+  parsed &= parser.grab_number(out.majflt);
+  skip_to(14);
+  parsed &= parser.grab_number(out.utime);
+  skip_to(15);
+  parsed &= parser.grab_number(out.stime);
+  skip_to(20);
+  parsed &= parser.grab_number(out.num_threads);
+  skip_to(23);
+  parsed &= parser.grab_number(out.vsize);
+  skip_to(24);
+  parsed &= parser.grab_number(out.rss);
+
+  return parsed;
+}
+
+/**
+ * @brief Reads /proc/self/stat.
+ *
+ * @details
+ * The file is kept open per thread and re-read by @ref source, nothing is
+ * allocated per call. See @ref parse_stat.
+ *
+ * @param[out] out Parsed fields.
+ *
+ * @return Success of reading.
+ */
+inline bool stat(process_stat& out) {
+#if defined(MYWR_LINUX)
+  static thread_local source file{"/proc/self/stat", 1024};
+
+  parser parser{file};
+  return !parser.fail() && parse_stat(parser, out);
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Data-structure for the page-size related fields of the region in
+ * /proc/self/smaps. Sizes are in bytes.
+ */
+struct smaps_region {
+  /**
+   * @brief The begin of the region.
+   */
+  std::uintptr_t begin{};
+
+  /**
+   * @brief The end of the region.
+   */
+  std::uintptr_t end{};
+
+  /**
+   * @brief Size of pages backing the region (`KernelPageSize`). Bigger than
+   * the base page only for hugetlbfs mappings.
+   */
+  std::size_t kernel_page_size{};
+
+  /**
+   * @brief Anonymous memory backed by transparent huge pages
+   * (`AnonHugePages`).
+   */
+  std::size_t anon_huge_pages{};
+
+  /**
+   * @brief Shared memory mapped with huge pages (`ShmemPmdMapped`).
+   */
+  std::size_t shmem_pmd_mapped{};
+
+  /**
+   * @brief File pages mapped with huge pages (`FilePmdMapped`).
+   */
+  std::size_t file_pmd_mapped{};
+
+  /**
+   * @brief Returns `true` if any part of the region is backed by huge pages.
+   */
+  MYWR_INLINE bool transparent_huge() const {
+    return anon_huge_pages + shmem_pmd_mapped + file_pmd_mapped != 0;
+  }
+};
+
+/**
+ * @brief Finds the region containing the address in the smaps text.
+ *
+ * @param[in]  parser  Parser over the contents of the smaps file.
+ * @param[in]  address The address to look for.
+ * @param[out] out     Parsed fields of the region.
+ *
+ * @return `true` if the region was found.
+ */
+static bool parse_smaps(parser&        parser,
+                        std::uintptr_t address,
+                        smaps_region&  out) {
+  bool found = false;
+
+  for (; !parser.eof(); parser.next_line()) {
+    parser.scope();
+    parser.next_until_space();
+
+    std::string_view token = parser.grab_view();
+    if (token.empty())
+      continue;
+
+    /**
+     * The header line of the next region: "begin-end perms ...".
+     */
+    if (token.back() != ':') {
+      if (found)
+        break;
+
+      std::size_t    dash  = token.find('-');
+      std::uintptr_t begin = 0;
+      std::uintptr_t end   = 0;
+      if (dash == std::string_view::npos)
+        continue;
+
+      std::from_chars(token.data(), token.data() + dash, begin, 16);
+      std::from_chars(
+          token.data() + dash + 1, token.data() + token.size(), end, 16);
+
+      if (address >= begin && address < end) {
+        out       = {};
+        out.begin = begin;
+        out.end   = end;
+        found     = true;
+      }
+      continue;
+    }
+
+    if (!found)
+      continue;
+
+    std::size_t* field = nullptr;
+    if (token == "KernelPageSize:")
+      field = &out.kernel_page_size;
+    else if (token == "AnonHugePages:")
+      field = &out.anon_huge_pages;
+    else if (token == "ShmemPmdMapped:")
+      field = &out.shmem_pmd_mapped;
+    else if (token == "FilePmdMapped:")
+      field = &out.file_pmd_mapped;
+    else
+      continue;
+
+    /**
+     * Sizes are reported in kB.
+     */
+    parser.next_until_any_char();
+    parser.scope();
+    parser.next_until_space();
+    parser.grab_number(*field);
+    *field *= 1024;
+  }
+
+  return found;
+}
+
+/**
+ * @brief Reads the page-size related fields of the region containing the
+ * address from /proc/self/smaps.
+ *
+ * @details
+ * The kernel walks page tables of every region to produce smaps, so it is
+ * much slower than @ref query_region. The file is kept open per thread.
+ *
+ * @param[in]  address The address to look for.
+ * @param[out] out     Parsed fields of the region.
+ *
+ * @return `true` if the region was found.
+ */
+static bool query_smaps(std::uintptr_t address, smaps_region& out) {
+#if defined(MYWR_LINUX)
+  static thread_local source file{"/proc/self/smaps", 256 * 1024};
+
+  parser parser{file};
+  return !parser.fail() && parse_smaps(parser, address, out);
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Returns the size of transparent huge pages, zero if they are not
+ * supported.
+ */
+static std::size_t transparent_huge_page_size() {
+#if defined(MYWR_LINUX)
+  return huge_page_size();
+#else
+  return 0;
+#endif
+}
 } // namespace procfs
 } // namespace mywr
 
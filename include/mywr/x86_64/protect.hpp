@@ -198,8 +198,8 @@ static uint32_t from_protection_constant(const memory_prot::Enum protect) {
  *
  * @details
  * On Windows uses `VirtualQuery` to get protection flags of memory area. On
- * Linux parses `proc/self/maps`. Returns @ref memory_prot::kNoAccess if error
- * acquired.
+ * Linux uses `PROCMAP_QUERY` ioctl if the kernel supports it, otherwise parses
+ * `proc/self/maps`. Returns @ref memory_prot::kUnknown if error acquired.
  *
  * @code{.cpp}
  * auto protect = mywr::protect::get_protect(0xDEADBEEF);
@@ -210,79 +210,1125 @@ static uint32_t from_protection_constant(const memory_prot::Enum protect) {
  * @return `memwrapper` specific memory protection constant.
  */
 static memory_prot::Enum get_protect(const address& target) {
+  MYWR_STATS_TIMER(kGetProtect);
+
 #if defined(MYWR_WINDOWS)
+  MYWR_STATS_COUNT(kSyscall);
+
   MEMORY_BASIC_INFORMATION mbi{};
   if (!VirtualQuery(target, &mbi, sizeof(mbi)))
     return memory_prot::kUnknown;
 
-  return to_protection_constant(mbi.Protect);
-#elif defined(MYWR_UNIX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  return to_protection_constant(mbi.Protect);
+#elif defined(MYWR_UNIX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  /**
+   * Look up the region with `PROCMAP_QUERY` or by parsing /proc/self/maps.
+   */
+  procfs::memory_region region{};
+  if (procfs::query_region(target.value(), region))
+    return to_protection_constant(region.permissions);
+
+  return memory_prot::kUnknown;
+#else
+  return memory_prot::kUnknown;
+#endif
+}
+
+/**
+ * @class huge_page_mode
+ * @brief Class that contains policies of protection changes inside huge pages.
+ */
+
+/**
+ * @enum huge_page_mode::Enum
+ * @brief Policies of protection changes inside huge pages.
+ */
+
+/**
+ * @var huge_page_mode::Enum huge_page_mode::kIgnore
+ * @brief Huge pages are not detected, protection is changed at the base page
+ * granularity. The default.
+ */
+
+/**
+ * @var huge_page_mode::Enum huge_page_mode::kReport
+ * @brief Splits are detected and counted by `stats::kHugePageSplit`, the
+ * protection is changed as in @ref huge_page_mode::kIgnore.
+ */
+
+/**
+ * @var huge_page_mode::Enum huge_page_mode::kAlign
+ * @brief The protection is changed for whole huge pages, so they are not
+ * split. Neighbour memory of the same huge page is changed too.
+ */
+
+/**
+ * @var huge_page_mode::Enum huge_page_mode::kRefuse
+ * @brief Changes which would split a huge page fail. Write such memory with
+ * a path not changing protections instead.
+ */
+class huge_page_mode {
+public:
+  enum Enum : std::uint32_t { kIgnore, kReport, kAlign, kRefuse };
+};
+
+/**
+ * @brief Data-structure describing huge pages affected by a protection change.
+ */
+struct huge_page_split {
+  /**
+   * @brief Size of huge pages backing the area, zero if there are none.
+   */
+  std::size_t page_size{};
+
+  /**
+   * @brief Number of huge pages the change would split.
+   */
+  std::size_t pages{};
+
+  /**
+   * @brief The begin of the area aligned to huge pages.
+   */
+  address_t begin{};
+
+  /**
+   * @brief The end of the area aligned to huge pages.
+   */
+  address_t end{};
+
+  /**
+   * @brief `true` for hugetlbfs pages. They can't be split at all, the kernel
+   * refuses unaligned changes.
+   */
+  bool hugetlb{};
+};
+
+namespace impl {
+inline std::atomic<huge_page_mode::Enum> g_huge_page_mode{
+    huge_page_mode::kIgnore};
+} // namespace impl
+
+/**
+ * @brief Sets the policy of @ref set_protect for areas inside huge pages.
+ *
+ * @details
+ * Detection reads /proc/self/smaps on every @ref set_protect call, use other
+ * modes than @ref huge_page_mode::kIgnore only when needed.
+ */
+MYWR_INLINE void set_huge_page_mode(const huge_page_mode::Enum mode) {
+  impl::g_huge_page_mode.store(mode, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the policy of @ref set_protect for areas inside huge pages.
+ */
+MYWR_INLINE huge_page_mode::Enum get_huge_page_mode() {
+  return impl::g_huge_page_mode.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Estimates how many huge pages a protection change of the area would
+ * split.
+ *
+ * @details
+ * On Linux reads /proc/self/smaps of the region: `KernelPageSize` reveals
+ * hugetlbfs mappings, `AnonHugePages`, `ShmemPmdMapped` and `FilePmdMapped`
+ * reveal transparent huge pages. Smaps doesn't tell which parts of the region
+ * are huge, so every aligned huge page inside the region is assumed to be
+ * huge. Changing protection of a part of such a page splits it into base
+ * pages for good, wasting TLB reach.
+ *
+ * @code{.cpp}
+ * auto split = mywr::protect::estimate_split(0xDEADBEEF, 4);
+ * if (split.pages != 0)
+ *   log("patch splits %zu huge pages", split.pages);
+ * @endcode
+ *
+ * @param[in] target The memory area.
+ * @param[in] size   The size of the memory area.
+ *
+ * @return Description of affected huge pages, zeroed if there are none.
+ */
+static huge_page_split estimate_split(const address&    target,
+                                      const std::size_t size) {
+  huge_page_split split{};
+
+#if defined(MYWR_LINUX)
+  procfs::smaps_region region{};
+  if (!procfs::query_smaps(target.value(), region))
+    return split;
+
+  std::size_t base_size = mywr::page_size();
+  if (region.kernel_page_size > base_size) {
+    split.page_size = region.kernel_page_size;
+    split.hugetlb   = true;
+  } else if (region.transparent_huge()) {
+    split.page_size = procfs::transparent_huge_page_size();
+  }
+
+  if (split.page_size == 0)
+    return split;
+
+  /**
+   * Area aligned to base pages, as the kernel changes it.
+   */
+  address_range area =
+      address_range::from_size(target, size ? size : 1).aligned(base_size);
+  address_range huge  = area.aligned(split.page_size);
+  address_t     begin = area.begin();
+  address_t     end   = area.end();
+
+  split.begin = huge.begin();
+  split.end   = huge.end();
+
+  /**
+   * Only huge pages lying in the region completely may exist, and only the
+   * partially changed ones at the edges are split.
+   */
+  auto splits = [&](address_t page) {
+    return page >= region.begin && page + split.page_size <= region.end &&
+           (begin > page || end < page + split.page_size);
+  };
+
+  split.pages = splits(split.begin);
+  if (split.end - split.begin > split.page_size)
+    split.pages += splits(split.end - split.page_size);
+
+  split.begin = std::max<address_t>(split.begin, region.begin);
+  split.end   = std::min<address_t>(split.end, region.end);
+#endif
+
+  return split;
+}
+
+/**
+ * @brief Sets new protection of specified memory address.
+ *
+ * @details
+ * On Windows uses `VirtualProtect`. On Linux uses `mprotect`. Areas inside
+ * huge pages are handled according to @ref set_huge_page_mode.
+ *
+ * @code{.cpp}
+ * using mywr::protect::memory_prot;
+ *
+ * auto prev_protect = mywr::protect::set_protect(0xDEADBEEF, 4096,
+ * memory_prot::kExecuteReadWrite);
+ * @endcode
+ */
+static memory_prot::Enum set_protect(const address&          target,
+                                     const std::size_t       size,
+                                     const memory_prot::Enum protect) {
+  MYWR_STATS_TIMER(kSetProtect);
+  MYWR_TRACE_SCOPE("protect::set_protect", size);
+
+#if defined(MYWR_WINDOWS)
+  MYWR_STATS_COUNT(kSyscall);
+
+  DWORD old_protect{};
+  if (!VirtualProtect(
+          target, size, from_protection_constant(protect), &old_protect))
+    return memory_prot::kUnknown;
+
+  return to_protection_constant(old_protect);
+#elif defined(MYWR_UNIX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  address_t     address = target.value();
+  address_range area    = address_range::from_size(target, size).page_aligned();
+
+  address_t aligned_address = area.begin();
+  size_t    aligned_size    = area.size();
+
+  // Don't split huge pages if asked.
+  huge_page_mode::Enum mode = get_huge_page_mode();
+  if (mode != huge_page_mode::kIgnore) {
+    huge_page_split split = estimate_split(target, size);
+    if (split.pages != 0) {
+      stats::count(stats::kHugePageSplit, split.pages);
+
+      if (mode == huge_page_mode::kRefuse)
+        return memory_prot::kUnknown;
+    }
+
+    if (split.page_size != 0 &&
+        (mode == huge_page_mode::kAlign || split.hugetlb)) {
+      aligned_address = split.begin;
+      aligned_size    = split.end - split.begin;
+    }
+  }
+
+  // Retrieve old protect on UNIX systems.
+  memory_prot::Enum old_protect = get_protect(address);
+
+  // Set new protect.
+  MYWR_STATS_COUNT(kSyscall);
+  if (mprotect(reinterpret_cast<void*>(aligned_address),
+               aligned_size,
+               from_protection_constant(protect)) != 0)
+    return memory_prot::kUnknown;
+
+  // And return old protect.
+  return old_protect;
+#else
+  return memory_prot::kUnknown;
+#endif
+}
+
+namespace impl {
+/**
+ * @brief Returns the protection allowing everything both protections allow.
+ */
+MYWR_INLINE memory_prot::Enum widen_protection(const memory_prot::Enum lhs,
+                                               const memory_prot::Enum rhs) {
+  if (lhs == rhs || rhs == memory_prot::kNoAccess)
+    return lhs;
+  if (lhs == memory_prot::kNoAccess)
+    return rhs;
+
+  std::uint32_t flags   = lhs | rhs;
+  bool          execute = flags & memory_prot::kExecute;
+  bool write = flags & (memory_prot::kWrite | memory_prot::kWriteCopy);
+
+  if (write)
+    return execute ? memory_prot::kExecuteReadWrite : memory_prot::kReadWrite;
+  return execute ? memory_prot::kExecuteRead : lhs;
+}
+
+/**
+ * @brief Slot of the @ref page_manager table. Owns the state of one page.
+ */
+struct alignas(64) page_slot {
+  std::atomic<address_t> page{0};
+  std::atomic<bool>      locked{false};
+  std::uint32_t          references{};
+  bool                   pending{};
+  memory_prot::Enum      original{};
+  memory_prot::Enum      current{};
+
+  /**
+   * @brief Acquires the slot spinlock.
+   */
+  MYWR_INLINE void lock() {
+    while (locked.exchange(true, std::memory_order_acquire)) {
+      while (locked.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+    }
+  }
+
+  /**
+   * @brief Releases the slot spinlock.
+   */
+  MYWR_INLINE void unlock() {
+    locked.store(false, std::memory_order_release);
+  }
+};
+
+constexpr std::size_t kPageShards     = 16;
+constexpr std::size_t kPageShardSlots = 64;
+
+/**
+ * @brief Areas spanning more pages are tracked by the @ref page_manager as
+ * ranges instead of page by page.
+ */
+constexpr std::size_t kMaxManagedPages = 64;
+
+/**
+ * @brief Run of pages sharing one state in the range table of the
+ * @ref page_manager. Keyed by the begin of the run.
+ */
+struct page_run {
+  address_t         end{};
+  std::uint32_t     references{};
+  bool              pending{};
+  memory_prot::Enum original{};
+  memory_prot::Enum current{};
+};
+
+/**
+ * @brief Returns the protection of the region containing `target` and the end
+ * of that region.
+ */
+inline memory_prot::Enum region_protection(address_t target, address_t& end) {
+#if defined(MYWR_WINDOWS)
+  MYWR_STATS_COUNT(kSyscall);
+
+  MEMORY_BASIC_INFORMATION mbi{};
+  if (!VirtualQuery(reinterpret_cast<LPCVOID>(target), &mbi, sizeof(mbi)))
+    return memory_prot::kUnknown;
+
+  end = reinterpret_cast<address_t>(mbi.BaseAddress) + mbi.RegionSize;
+  return to_protection_constant(mbi.Protect);
+#elif defined(MYWR_UNIX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  procfs::memory_region region{};
+  if (!procfs::query_region(target, region))
+    return memory_prot::kUnknown;
+
+  end = region.end;
+  return to_protection_constant(region.permissions);
+#else
+  (void)target;
+  (void)end;
+  return memory_prot::kUnknown;
+#endif
+}
+
+/**
+ * @brief Shard of the @ref page_manager table. Open addressing, keys are
+ * never removed, unreferenced slots are reused by new pages.
+ */
+struct page_shard {
+  std::atomic<bool> inserting{false};
+  page_slot         slots[kPageShardSlots];
+};
+
+inline page_shard g_page_shards[kPageShards];
+} // namespace impl
+
+/**
+ * @class page_manager
+ * @brief Process-wide reference counter of temporarily changed page
+ * protections.
+ *
+ * @details
+ * Every page changed through the manager remembers its original protection
+ * and the number of holders. The original protection is restored only when
+ * the last holder releases the page, so concurrent @ref scoped_protect
+ * objects on the same page no longer restore it under each other.
+ *
+ * Pages are kept in a sharded open-addressing table. Looking up a known page
+ * is lock-free, only the page transition itself takes the per-page spinlock;
+ * inserting a new page takes the lock of its shard. If holders request
+ * different protections, the page gets the union of them until the last one
+ * releases it.
+ *
+ * Areas larger than `impl::kMaxManagedPages` pages, and pages which don't fit
+ * into the table, are reference-counted as runs of pages in the range table
+ * under a mutex, one protection change per run. The range table takes over
+ * the held pages of the table it overlaps, and while it isn't empty new areas
+ * are acquired through it too, so every page is counted in one place.
+ *
+ * In the deferred restore mode (@ref set_deferred) the last holder doesn't
+ * restore the page, it stays changed until @ref flush_epoch. Pages patched
+ * many times per epoch are changed and restored once, later holders find the
+ * page already changed and skip the system call. Call @ref flush_epoch before
+ * unmapping or changing protection of such pages by other means.
+ *
+ * @code{.cpp}
+ * auto& manager = mywr::protect::page_manager::instance();
+ *
+ * if (manager.acquire(0xDEADBEEF, 4, memory_prot::kExecuteReadWrite) !=
+ *     memory_prot::kUnknown) {
+ *   // ... patch ...
+ *   manager.release(0xDEADBEEF, 4);
+ * }
+ * @endcode
+ */
+class page_manager {
+public:
+  /**
+   * @brief Returns the process-wide instance.
+   */
+  static page_manager& instance() {
+    static page_manager manager;
+    return manager;
+  }
+
+  /**
+   * @brief Sets the protection of every page in the area and takes the
+   * reference to it.
+   *
+   * @param[in] target  The memory area.
+   * @param[in] size    The size of the memory area.
+   * @param[in] protect The protection to set.
+   *
+   * @return The original protection of the first page or
+   * @ref memory_prot::kUnknown on error. On error no references are taken.
+   */
+  memory_prot::Enum acquire(const address&          target,
+                            const std::size_t       size,
+                            const memory_prot::Enum protect) {
+    address_range area =
+        address_range::from_size(target, size ? size : 1).page_aligned();
+
+    if (area.page_count() <= impl::kMaxManagedPages && m_ranges.load() == 0) {
+      bool              fallback = false;
+      memory_prot::Enum result   = acquire_pages(area, protect, fallback);
+      if (!fallback)
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return acquire_range(area, protect);
+  }
+
+  /**
+   * @brief Releases the references taken by @ref acquire. The last holder
+   * restores the original protection.
+   *
+   * @param[in] target The memory area.
+   * @param[in] size   The size of the memory area.
+   */
+  void release(const address& target, const std::size_t size) {
+    address_range area =
+        address_range::from_size(target, size ? size : 1).page_aligned();
+
+    bool deferred = false;
+    if (m_ranges.load() == 0) {
+      for (address_t page : area.pages()) {
+        if (release_page(page, deferred))
+          continue;
+
+        // The page was taken over by the range table meanwhile.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        release_range({page, page + mywr::page_size()}, deferred);
+      }
+    } else {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      release_range(area, deferred);
+    }
+
+    if (deferred)
+      flush_expired_epoch();
+  }
+
+  /**
+   * @brief Enables or disables the deferred restore mode. Disabling flushes
+   * the pending pages.
+   *
+   * @param[in] enabled Enables the mode.
+   * @param[in] budget  Maximum age of the epoch. The release that finds the
+   * epoch older flushes it. Zero means only explicit @ref flush_epoch.
+   */
+  void set_deferred(const bool                      enabled,
+                    const std::chrono::microseconds budget = {}) {
+    m_budget.store(std::chrono::duration_cast<std::chrono::nanoseconds>(budget)
+                       .count(),
+                   std::memory_order_relaxed);
+    m_deferred.store(enabled, std::memory_order_release);
+
+    if (!enabled)
+      flush_epoch();
+  }
+
+  /**
+   * @brief Returns `true` if the deferred restore mode is enabled.
+   */
+  MYWR_INLINE bool deferred() const {
+    return m_deferred.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Restores all pages released since the previous epoch.
+   *
+   * @return The number of restored pages.
+   */
+  std::size_t flush_epoch() {
+    std::size_t restored = 0;
+    if (m_pending.load(std::memory_order_acquire) == 0) {
+      m_epoch.store(0, std::memory_order_relaxed);
+      return restored;
+    }
+
+    for (auto& shard : impl::g_page_shards) {
+      for (auto& slot : shard.slots) {
+        if (slot.page.load(std::memory_order_relaxed) == 0)
+          continue;
+
+        slot.lock();
+        if (slot.pending && slot.references == 0) {
+          restore(slot);
+          restored++;
+        }
+        slot.unlock();
+      }
+    }
+
+    if (m_ranges.load() != 0) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto it = m_runs.begin(); it != m_runs.end();) {
+        if (it->second.pending && it->second.references == 0) {
+          restored += restore(it->first, it->second);
+          it = erase_run(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    m_epoch.store(0, std::memory_order_relaxed);
+    return restored;
+  }
+
+  /**
+   * @brief Returns the number of pages waiting for @ref flush_epoch.
+   */
+  MYWR_INLINE std::size_t pending() const {
+    return m_pending.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the number of holders of the page containing `target`.
+   */
+  std::uint32_t references(const address& target) {
+    if (m_ranges.load() != 0) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto                        run = run_of(page_of(target.value()));
+      if (run != m_runs.end())
+        return run->second.references;
+    }
+
+    impl::page_slot* slot = find(page_of(target.value()));
+    if (!slot)
+      return 0;
+
+    slot->lock();
+    std::uint32_t references =
+        slot->page.load(std::memory_order_relaxed) == page_of(target.value())
+            ? slot->references
+            : 0;
+    slot->unlock();
+    return references;
+  }
+
+private:
+  /**
+   * @brief Returns the begin of the page containing `address`.
+   */
+  MYWR_INLINE static address_t page_of(address_t address) {
+    return address & ~static_cast<address_t>(mywr::page_size() - 1);
+  }
+
+  /**
+   * @brief Returns the hash of the page.
+   */
+  MYWR_INLINE static std::size_t hash_of(address_t page) {
+    std::uint64_t number = static_cast<std::uint64_t>(page) /
+                           static_cast<std::uint64_t>(mywr::page_size());
+    return static_cast<std::size_t>((number * 0x9E3779B97F4A7C15ull) >> 32);
+  }
+
+  /**
+   * @brief Returns the shard of the page.
+   */
+  MYWR_INLINE static impl::page_shard& shard_of(address_t page) {
+    return impl::g_page_shards[hash_of(page) % impl::kPageShards];
+  }
+
+  /**
+   * @brief Lock-free lookup of the slot owning the page.
+   */
+  static impl::page_slot* find(address_t page) {
+    impl::page_shard& shard = shard_of(page);
+    std::size_t       start = hash_of(page) / impl::kPageShards;
+
+    for (std::size_t i = 0; i < impl::kPageShardSlots; i++) {
+      impl::page_slot& slot =
+          shard.slots[(start + i) % impl::kPageShardSlots];
+
+      address_t key = slot.page.load(std::memory_order_acquire);
+      if (key == page)
+        return &slot;
+      if (key == 0)
+        return nullptr;
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Returns the monotonic time in nanoseconds.
+   */
+  MYWR_INLINE static std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /**
+   * @brief Restores the original protection of the pending page. The slot
+   * must be locked.
+   */
+  void restore(impl::page_slot& slot) {
+    set_protect(slot.page.load(std::memory_order_relaxed),
+                mywr::page_size(),
+                slot.original);
+    slot.pending = false;
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Restores the original protection of the pending run.
+   *
+   * @return The number of restored pages.
+   */
+  std::size_t restore(address_t begin, impl::page_run& run) {
+    set_protect(begin, run.end - begin, run.original);
+    run.pending = false;
+
+    std::size_t pages = (run.end - begin) / mywr::page_size();
+    m_pending.fetch_sub(pages, std::memory_order_relaxed);
+    return pages;
+  }
+
+  /**
+   * @brief Starts the epoch if nothing was deferred yet.
+   */
+  void start_epoch() {
+    std::int64_t begin = 0;
+    if (m_epoch.load(std::memory_order_relaxed) == 0)
+      m_epoch.compare_exchange_strong(begin, now(), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Flushes the epoch if it is older than the budget.
+   */
+  void flush_expired_epoch() {
+    std::int64_t budget = m_budget.load(std::memory_order_relaxed);
+    if (budget != 0 &&
+        now() - m_epoch.load(std::memory_order_relaxed) >= budget)
+      flush_epoch();
+  }
+
+  /**
+   * @brief Finds the slot of the page or assigns a free one. Returns the
+   * slot locked, or `nullptr` if the shard is full of referenced pages.
+   */
+  impl::page_slot* lock_slot(address_t page) {
+    while (true) {
+      if (impl::page_slot* slot = find(page)) {
+        slot->lock();
+        // The slot may be reassigned between the lookup and the lock.
+        if (slot->page.load(std::memory_order_relaxed) == page)
+          return slot;
+        slot->unlock();
+        continue;
+      }
+
+      impl::page_shard& shard = shard_of(page);
+      while (shard.inserting.exchange(true, std::memory_order_acquire))
+        std::this_thread::yield();
+
+      impl::page_slot* result = nullptr;
+      bool             full   = false;
+      if (!find(page)) {
+        std::size_t start = hash_of(page) / impl::kPageShards;
+        for (std::size_t i = 0; i < impl::kPageShardSlots && !result; i++) {
+          impl::page_slot& slot =
+              shard.slots[(start + i) % impl::kPageShardSlots];
+
+          // Take the empty slot or reuse the unreferenced one.
+          slot.lock();
+          if (slot.page.load(std::memory_order_relaxed) == 0 ||
+              slot.references == 0) {
+            if (slot.pending)
+              restore(slot);
+
+            slot.page.store(page, std::memory_order_release);
+            result = &slot;
+          } else {
+            slot.unlock();
+          }
+        }
+        full = !result;
+      }
+
+      shard.inserting.store(false, std::memory_order_release);
+
+      if (result || full)
+        return result;
+
+      // Another thread inserted the page meanwhile, look it up again.
+    }
+  }
+
+  /**
+   * @brief Takes the references to the pages of the small area in the table.
+   *
+   * @param[out] fallback Set if the area must be acquired by
+   * @ref acquire_range instead. No references are taken then.
+   */
+  memory_prot::Enum acquire_pages(const address_range&    area,
+                                  const memory_prot::Enum protect,
+                                  bool&                   fallback) {
+    memory_prot::Enum result = memory_prot::kUnknown;
+    for (address_t page : area.pages()) {
+      memory_prot::Enum original = acquire_page(page, protect, fallback);
+      if (original == memory_prot::kUnknown) {
+        // Roll back already taken references.
+        if (page != area.begin())
+          release(area.begin(), page - area.begin());
+        return memory_prot::kUnknown;
+      }
+
+      if (result == memory_prot::kUnknown)
+        result = original;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Takes the reference to the page.
+   */
+  memory_prot::Enum acquire_page(address_t               page,
+                                 const memory_prot::Enum protect,
+                                 bool&                   fallback) {
+    impl::page_slot* slot = lock_slot(page);
+    if (!slot) {
+      // The shard is full, track the area as a range.
+      fallback = true;
+      return memory_prot::kUnknown;
+    }
+
+    // Checked under the slot lock: @ref take_pages either sees this page or
+    // this check sees the range table in use.
+    if (m_ranges.load() != 0) {
+      slot->unlock();
+      fallback = true;
+      return memory_prot::kUnknown;
+    }
+
+    // The pending page is not restored yet, reuse it as if it was still held.
+    if (slot->references == 0 && !slot->pending) {
+      memory_prot::Enum original =
+          set_protect(page, mywr::page_size(), protect);
+      if (original == memory_prot::kUnknown) {
+        slot->unlock();
+        return memory_prot::kUnknown;
+      }
+
+      slot->original = original;
+      slot->current  = protect;
+    } else if (slot->current != protect) {
+      // Other holders are still using the page, only widen its protection.
+      memory_prot::Enum widened =
+          impl::widen_protection(slot->current, protect);
+      if (widened != slot->current &&
+          set_protect(page, mywr::page_size(), widened) ==
+              memory_prot::kUnknown) {
+        slot->unlock();
+        return memory_prot::kUnknown;
+      }
+      slot->current = widened;
+    }
+
+    if (slot->pending) {
+      slot->pending = false;
+      m_pending.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    slot->references++;
+    memory_prot::Enum original = slot->original;
+    slot->unlock();
+    return original;
+  }
+
+  /**
+   * @brief Releases the reference to the page held in the table.
+   *
+   * @param[out] deferred Set if the restore was deferred.
+   *
+   * @return `false` if the table holds no reference to the page.
+   */
+  bool release_page(address_t page, bool& deferred) {
+    impl::page_slot* slot = find(page);
+    if (!slot)
+      return false;
+
+    bool found = false;
+
+    slot->lock();
+    if (slot->page.load(std::memory_order_relaxed) == page &&
+        slot->references != 0) {
+      found = true;
+      if (--slot->references == 0) {
+        if (m_deferred.load(std::memory_order_acquire)) {
+          // Leave the page changed until the end of the epoch.
+          m_pending.fetch_add(1, std::memory_order_relaxed);
+          start_epoch();
+
+          slot->pending = true;
+          deferred      = true;
+        } else {
+          set_protect(page, mywr::page_size(), slot->original);
+        }
+      }
+    }
+    slot->unlock();
+    return found;
+  }
+
+  /**
+   * @brief Returns the run containing the page. @ref m_mutex must be held.
+   */
+  std::map<address_t, impl::page_run>::iterator run_of(address_t page) {
+    auto it = m_runs.upper_bound(page);
+    if (it == m_runs.begin())
+      return m_runs.end();
+
+    --it;
+    return page < it->second.end ? it : m_runs.end();
+  }
+
+  /**
+   * @brief Splits the run containing `at`, so a run begins there.
+   * @ref m_mutex must be held.
+   */
+  void split_run(address_t at) {
+    auto it = run_of(at);
+    if (it == m_runs.end() || it->first == at)
+      return;
+
+    impl::page_run tail = it->second;
+    it->second.end      = at;
+    m_runs.emplace(at, tail);
+    m_ranges.fetch_add(1);
+  }
+
+  /**
+   * @brief Removes the run. @ref m_mutex must be held.
+   */
+  std::map<address_t, impl::page_run>::iterator
+      erase_run(std::map<address_t, impl::page_run>::iterator it) {
+    m_ranges.fetch_sub(1);
+    return m_runs.erase(it);
+  }
+
+  /**
+   * @brief Moves the pages of the area held in the table to the range table.
+   * @ref m_mutex must be held.
+   */
+  void take_pages(const address_range& area) {
+    // Every slot is locked, a page being inserted is either seen here or its
+    // holder sees the range table in use, see @ref acquire_page.
+    for (auto& shard : impl::g_page_shards) {
+      for (auto& slot : shard.slots) {
+        slot.lock();
+        address_t page = slot.page.load(std::memory_order_relaxed);
+        if (page != 0 && area.contains(page) &&
+            (slot.references != 0 || slot.pending)) {
+          m_runs.emplace(page,
+                         impl::page_run{page + mywr::page_size(),
+                                        slot.references,
+                                        slot.pending,
+                                        slot.original,
+                                        slot.current});
+          m_ranges.fetch_add(1);
+
+          slot.references = 0;
+          slot.pending    = false;
+        }
+        slot.unlock();
+      }
+    }
+  }
+
+  /**
+   * @brief Takes the reference to the page-aligned area in the range table.
+   * @ref m_mutex must be held.
+   */
+  memory_prot::Enum acquire_range(const address_range&    area,
+                                  const memory_prot::Enum protect) {
+    // Keeps new areas off the table until its pages are taken over.
+    m_ranges.fetch_add(1);
+    take_pages(area);
+    split_run(area.begin());
+    split_run(area.end());
+
+    memory_prot::Enum result = memory_prot::kUnknown;
+    address_t         cursor = area.begin();
+    while (cursor < area.end()) {
+      auto it = m_runs.lower_bound(cursor);
+      if (it != m_runs.end() && it->first == cursor) {
+        if (!acquire_run(it->first, it->second, protect))
+          break;
+
+        if (result == memory_prot::kUnknown)
+          result = it->second.original;
+        cursor = it->second.end;
+        continue;
+      }
+
+      // Pages nobody holds, one run per region of the same protection.
+      address_t end = it != m_runs.end() ? std::min(it->first, area.end())
+                                         : area.end();
+      address_t region_end = 0;
+      memory_prot::Enum original = impl::region_protection(cursor, region_end);
+      if (original == memory_prot::kUnknown || region_end <= cursor)
+        break;
+
+      end = std::min(end, region_end);
+      if (set_protect(cursor, end - cursor, protect) == memory_prot::kUnknown)
+        break;
+
+      m_runs.emplace(cursor, impl::page_run{end, 1, false, original, protect});
+      m_ranges.fetch_add(1);
+
+      if (result == memory_prot::kUnknown)
+        result = original;
+      cursor = end;
+    }
+
+    if (cursor < area.end()) {
+      // Roll back already taken references.
+      bool deferred = false;
+      release_range({area.begin(), cursor}, deferred);
+      result = memory_prot::kUnknown;
+    }
+
+    m_ranges.fetch_sub(1);
+    return result;
+  }
+
+  /**
+   * @brief Takes the reference to the run.
+   */
+  bool acquire_run(address_t               begin,
+                   impl::page_run&         run,
+                   const memory_prot::Enum protect) {
+    if (run.current != protect) {
+      // Other holders are still using the pages, only widen their protection.
+      memory_prot::Enum widened = impl::widen_protection(run.current, protect);
+      if (widened != run.current &&
+          set_protect(begin, run.end - begin, widened) ==
+              memory_prot::kUnknown)
+        return false;
+      run.current = widened;
+    }
+
+    if (run.pending) {
+      run.pending = false;
+      m_pending.fetch_sub((run.end - begin) / mywr::page_size(),
+                          std::memory_order_relaxed);
+    }
+
+    run.references++;
+    return true;
+  }
+
   /**
-   * Parse /proc/self/maps to retrieve memory protect information.
+   * @brief Releases the references to the page-aligned area. Pages outside of
+   * the range table are released in the table. @ref m_mutex must be held.
+   *
+   * @param[out] deferred Set if a restore was deferred.
    */
-  std::vector<procfs::memory_region> regions;
-  procfs::parse_maps(regions);
+  void release_range(const address_range& area, bool& deferred) {
+    split_run(area.begin());
+    split_run(area.end());
+
+    address_t cursor = area.begin();
+    while (cursor < area.end()) {
+      auto it = m_runs.lower_bound(cursor);
+      if (it != m_runs.end() && it->first == cursor) {
+        cursor = it->second.end;
+        release_run(it, deferred);
+        continue;
+      }
+
+      address_t end = it != m_runs.end() ? std::min(it->first, area.end())
+                                         : area.end();
+      for (address_t page : address_range{cursor, end}.pages())
+        release_page(page, deferred);
+      cursor = end;
+    }
+  }
 
   /**
-   * Get address of passed `target`.
+   * @brief Releases the reference to the run. The last holder restores the
+   * original protection.
    */
-  address_t address = target.value();
+  void release_run(std::map<address_t, impl::page_run>::iterator it,
+                   bool&                                         deferred) {
+    impl::page_run& run = it->second;
+    if (run.references == 0 || --run.references != 0)
+      return;
+
+    if (m_deferred.load(std::memory_order_acquire)) {
+      // Leave the pages changed until the end of the epoch.
+      m_pending.fetch_add((run.end - it->first) / mywr::page_size(),
+                          std::memory_order_relaxed);
+      start_epoch();
+
+      run.pending = true;
+      deferred    = true;
+    } else {
+      set_protect(it->first, run.end - it->first, run.original);
+      erase_run(it);
+    }
+  }
 
   /**
-   * Foreach all region and check for protect.
+   * @name Private Member variables
+   * @{
    */
-  for (auto& region : regions)
-    if (address >= region.begin && address <= region.end)
-      return to_protection_constant(region.permissions);
 
-  return memory_prot::kUnknown;
-#else
-  return memory_prot::kUnknown;
-#endif
-}
+  /**
+   * @brief Deferred restore mode.
+   */
+  std::atomic<bool> m_deferred{false};
+
+  /**
+   * @brief Maximum age of the epoch in nanoseconds, zero if unlimited.
+   */
+  std::atomic<std::int64_t> m_budget{0};
+
+  /**
+   * @brief The begin of the current epoch, zero if nothing was deferred.
+   */
+  std::atomic<std::int64_t> m_epoch{0};
+
+  /**
+   * @brief The number of pages waiting for the restore.
+   */
+  std::atomic<std::size_t> m_pending{0};
+
+  /**
+   * @brief Runs of the range table plus acquires in progress. Zero lets small
+   * areas use the lock-free table.
+   */
+  std::atomic<std::size_t> m_ranges{0};
+
+  /**
+   * @brief Guards the range table.
+   */
+  std::mutex m_mutex{};
+
+  /**
+   * @brief The range table: non-overlapping page-aligned runs.
+   */
+  std::map<address_t, impl::page_run> m_runs{};
+
+  /**
+   * @}
+   */
+};
 
 /**
- * @brief Sets new protection of specified memory address.
- *
- * @details
- * On Windows uses `VirtualProtect`. On Linux uses `mprotect`.
+ * @brief Enables or disables the deferred restore of protections changed by
+ * @ref scoped_protect.
  *
  * @code{.cpp}
- * using mywr::protect::memory_prot;
+ * mywr::protect::set_deferred_restore(true);
  *
- * auto prev_protect = mywr::protect::set_protect(0xDEADBEEF, 4096,
- * memory_prot::kExecuteReadWrite);
+ * while (running) {
+ *   patch_frame(); // Every page is unprotected once per frame.
+ *   mywr::protect::flush_epoch();
+ * }
  * @endcode
+ *
+ * @param[in] enabled Enables the mode.
+ * @param[in] budget  Maximum age of the epoch, zero means only explicit
+ * @ref flush_epoch.
  */
-static memory_prot::Enum set_protect(const address&          target,
-                                     const std::size_t       size,
-                                     const memory_prot::Enum protect) {
-#if defined(MYWR_WINDOWS)
-  DWORD old_protect{};
-  if (!VirtualProtect(
-          target, size, from_protection_constant(protect), &old_protect))
-    return memory_prot::kUnknown;
-
-  return to_protection_constant(old_protect);
-#elif defined(MYWR_UNIX) && !defined(MYWR_FEATURE_NO_MPROTECT)
-  address_t address         = target.value();
-  address_t aligned_address = address & ~(sysconf(_SC_PAGE_SIZE) - 1u);
-  size_t    aligned_size    = size + (address - aligned_address);
-
-  // Retrieve old protect on UNIX systems.
-  memory_prot::Enum old_protect = get_protect(address);
-
-  // Set new protect.
-  if (mprotect(reinterpret_cast<void*>(aligned_address),
-               aligned_size,
-               from_protection_constant(protect)) != 0)
-    return memory_prot::kUnknown;
+MYWR_INLINE void
+    set_deferred_restore(const bool                      enabled,
+                         const std::chrono::microseconds budget = {}) {
+  page_manager::instance().set_deferred(enabled, budget);
+}
 
-  // And return old protect.
-  return old_protect;
-#else
-  return memory_prot::kUnknown;
-#endif
+/**
+ * @brief Restores the protections deferred since the previous epoch.
+ *
+ * @return The number of restored pages.
+ */
+MYWR_INLINE std::size_t flush_epoch() {
+  return page_manager::instance().flush_epoch();
 }
 
 /**
@@ -292,6 +1338,11 @@ static memory_prot::Enum set_protect(const address&          target,
  * During construction, it sets the specified memory protection and saves the
  * old one. When exiting the scope, it restores the old memory protection, if no
  * errors have occurred.
+ *
+ * Protections are changed through the @ref page_manager, so the pages shared
+ * with other alive @ref scoped_protect objects, including ones of other
+ * threads, are restored only by the last of them. Large areas (bulk fills
+ * and copies) are tracked as ranges, one protection change per region.
  */
 class scoped_protect {
 public:
@@ -351,7 +1402,8 @@ public:
                  const memory_prot::Enum protect)
       : m_target(target)
       , m_size(size)
-      , m_old_protect(set_protect(target, size, protect)) {}
+      , m_old_protect(page_manager::instance().acquire(target, size, protect)) {
+  }
 
   /**
    * @brief Destructor.
@@ -361,7 +1413,7 @@ public:
    */
   ~scoped_protect() {
     if (good())
-      set_protect(m_target, m_size, m_old_protect);
+      page_manager::instance().release(m_target, m_size);
   }
   /**
    * @}
@@ -382,6 +1434,13 @@ public:
     return m_old_protect != memory_prot::kUnknown;
   }
 
+  /**
+   * @brief Returns the original protection of the first page of the area.
+   */
+  MYWR_INLINE memory_prot::Enum old_protect() const {
+    return m_old_protect;
+  }
+
   /**
    * @}
    */
@@ -410,6 +1469,361 @@ private:
    * @}
    */
 };
+
+#if defined(MYWR_LINUX) && defined(MYWR_GCC) && defined(SYS_pkey_alloc) &&    \
+    !defined(MYWR_FEATURE_NO_MPROTECT)
+  #define MYWR_FEATURE_PKEYS
+#endif
+
+#if defined(MYWR_FEATURE_PKEYS)
+namespace impl {
+/**
+ * @brief Reads PKRU register of the current thread (`RDPKRU`).
+ */
+MYWR_FORCEINLINE std::uint32_t read_pkru() {
+  std::uint32_t eax{};
+  std::uint32_t edx{};
+  asm volatile(".byte 0x0f, 0x01, 0xee" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+}
+
+/**
+ * @brief Writes PKRU register of the current thread (`WRPKRU`).
+ */
+MYWR_FORCEINLINE void write_pkru(std::uint32_t pkru) {
+  asm volatile(".byte 0x0f, 0x01, 0xef" : : "a"(pkru), "c"(0), "d"(0)
+               : "memory");
+}
+
+/**
+ * @brief Access-disable and write-disable bits of the key in PKRU.
+ */
+constexpr std::uint32_t kPkruAccessDisable = 0x1;
+constexpr std::uint32_t kPkruWriteDisable  = 0x2;
+} // namespace impl
+#endif
+
+/**
+ * @class pkey_domain
+ * @brief Group of patchable regions which writability is toggled together.
+ *
+ * @details
+ * With the protection keys backend (x86 PKU, Linux 4.9+) the regions are
+ * tagged with the dedicated key once via `pkey_mprotect` and become writable
+ * in the page tables. Whether the thread may actually write is decided by its
+ * PKRU register, so @ref pkey_domain::enable_write() and
+ * @ref pkey_domain::disable_write() are a single `WRPKRU` instruction each:
+ * no syscalls, no `mmap_lock`, no TLB shootdowns. The toggle affects only the
+ * calling thread.
+ *
+ * Protection keys don't restrict instruction fetch, but they do restrict data
+ * reads: threads which never enabled writing keep the kernel's default PKRU,
+ * which usually denies any data access to non-default keys. So tag only code
+ * or memory read by the patching threads themselves.
+ *
+ * When the CPU or the kernel doesn't support protection keys (detected at
+ * runtime), the domain falls back to `mprotect` of every tagged region.
+ *
+ * @code{.cpp}
+ * mywr::protect::pkey_domain domain;
+ * domain.tag(code, code_size);
+ *
+ * {
+ *   mywr::protect::scoped_write write{domain};
+ *   patch(code);
+ * }
+ * @endcode
+ */
+class pkey_domain {
+public:
+  /**
+   * @brief Backends of the domain.
+   */
+  enum backend_type : std::uint32_t {
+    kAuto,
+    kPkey,
+    kMprotect
+  };
+
+  /**
+   * @name Constructors & Destructor.
+   * @{
+   */
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  pkey_domain(const pkey_domain&) = delete;
+
+  /**
+   * @brief Move constructor forbidden.
+   */
+  pkey_domain(pkey_domain&&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const pkey_domain&) = delete;
+
+  /**
+   * @brief Move operator forbidden.
+   */
+  void operator=(pkey_domain&&) = delete;
+
+  /**
+   * @brief Main constructor. Allocates the protection key.
+   *
+   * @param[in] backend The preferred backend. @ref kAuto and @ref kPkey try
+   * protection keys first and fall back to `mprotect`.
+   */
+  explicit pkey_domain(const backend_type backend = kAuto) {
+#if defined(MYWR_FEATURE_PKEYS)
+    if (backend != kMprotect)
+      m_key = static_cast<int>(
+          syscall(SYS_pkey_alloc, 0, impl::kPkruWriteDisable));
+#endif
+    m_backend = m_key >= 0 ? kPkey : kMprotect;
+  }
+
+  /**
+   * @brief Destructor. Restores original protection of tagged regions and
+   * frees the key.
+   */
+  ~pkey_domain() {
+    for (const auto& region : m_regions) {
+#if defined(MYWR_FEATURE_PKEYS)
+      if (m_backend == kPkey) {
+        syscall(SYS_pkey_mprotect,
+                region.begin,
+                region.size,
+                from_protection_constant(region.original),
+                0);
+        continue;
+      }
+#endif
+      set_protect(region.begin, region.size, region.original);
+    }
+
+#if defined(MYWR_FEATURE_PKEYS)
+    if (m_key >= 0)
+      syscall(SYS_pkey_free, m_key);
+#endif
+  }
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Public Member Functions
+   * @{
+   */
+
+  /**
+   * @brief Returns the backend used by the domain.
+   */
+  MYWR_INLINE backend_type backend() const {
+    return m_backend;
+  }
+
+  /**
+   * @brief Adds the region to the domain. The region stays non-writable until
+   * @ref enable_write().
+   *
+   * @param[in] target The begin of the region.
+   * @param[in] size   The size of the region.
+   *
+   * @return Success of tagging.
+   */
+  bool tag(const address& target, const std::size_t size) {
+    memory_prot::Enum original = get_protect(target);
+    if (original == memory_prot::kUnknown)
+      return false;
+
+    address_range area  = address_range::from_size(target, size).page_aligned();
+    address_t     begin = area.begin();
+    address_t     end   = area.end();
+
+#if defined(MYWR_FEATURE_PKEYS)
+    if (m_backend == kPkey) {
+      std::uint32_t writable = from_protection_constant(original) | PROT_WRITE;
+      if (syscall(SYS_pkey_mprotect, begin, end - begin, writable, m_key) != 0)
+        return false;
+    }
+#endif
+
+    m_regions.push_back({begin, end - begin, original});
+    return true;
+  }
+
+  /**
+   * @brief Allows writing to tagged regions. With protection keys only for
+   * the calling thread.
+   */
+  bool enable_write() {
+#if defined(MYWR_FEATURE_PKEYS)
+    if (m_backend == kPkey) {
+      impl::write_pkru(impl::read_pkru() & ~key_mask());
+      return true;
+    }
+#endif
+
+    // Later writers wait until the first one has changed the protection.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writers.fetch_add(1, std::memory_order_acq_rel) != 0)
+      return true;
+
+    bool result = true;
+    for (const auto& region : m_regions) {
+      auto protect = from_protection_constant(region.original) | PROT_WRITE;
+      result &= set_protect(region.begin,
+                            region.size,
+                            to_protection_constant(protect)) !=
+                memory_prot::kUnknown;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Forbids writing to tagged regions again.
+   */
+  bool disable_write() {
+#if defined(MYWR_FEATURE_PKEYS)
+    if (m_backend == kPkey) {
+      std::uint32_t pkru = impl::read_pkru() & ~key_mask();
+      impl::write_pkru(pkru | (impl::kPkruWriteDisable << (m_key * 2)));
+      return true;
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writers.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return true;
+
+    bool result = true;
+    for (const auto& region : m_regions)
+      result &= set_protect(region.begin, region.size, region.original) !=
+                memory_prot::kUnknown;
+    return result;
+  }
+
+  /**
+   * @brief Returns `true` if the calling thread may write to tagged regions.
+   */
+  bool writable() const {
+#if defined(MYWR_FEATURE_PKEYS)
+    if (m_backend == kPkey)
+      return (impl::read_pkru() & key_mask()) == 0;
+#endif
+    return m_writers.load(std::memory_order_acquire) != 0;
+  }
+
+  /**
+   * @}
+   */
+
+private:
+  /**
+   * @brief Tagged region with its original protection.
+   */
+  struct tagged_region {
+    address_t         begin;
+    std::size_t       size;
+    memory_prot::Enum original;
+  };
+
+  /**
+   * @brief Mask of the key's bits in PKRU.
+   */
+  MYWR_INLINE std::uint32_t key_mask() const {
+    return 0x3u << (m_key * 2);
+  }
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief Used backend.
+   */
+  backend_type m_backend{kMprotect};
+
+  /**
+   * @brief Allocated protection key or -1.
+   */
+  int m_key{-1};
+
+  /**
+   * @brief Number of active writers (`mprotect` backend).
+   */
+  std::atomic<std::uint32_t> m_writers{0};
+
+  /**
+   * @brief Serializes protection changes of the `mprotect` backend.
+   */
+  std::mutex m_mutex{};
+
+  /**
+   * @brief Tagged regions.
+   */
+  std::vector<tagged_region> m_regions{};
+
+  /**
+   * @}
+   */
+};
+
+/**
+ * @brief RAII class for writing to regions of the @ref pkey_domain.
+ */
+class scoped_write {
+public:
+  /**
+   * @brief Default constructor forbidden.
+   */
+  scoped_write() = delete;
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  scoped_write(const scoped_write&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const scoped_write&) = delete;
+
+  /**
+   * @brief Enables writing to the domain. Nested scopes of the same thread
+   * are cheap with protection keys, `mprotect` backend counts writers.
+   */
+  explicit scoped_write(pkey_domain& domain)
+      : m_domain(domain)
+      , m_was_writable(domain.backend() == pkey_domain::kPkey &&
+                       domain.writable())
+      , m_good(m_was_writable || domain.enable_write()) {}
+
+  /**
+   * @brief Disables writing, unless it was already enabled before.
+   */
+  ~scoped_write() {
+    if (!m_was_writable && m_good)
+      m_domain.disable_write();
+  }
+
+  /**
+   * @brief Returns `true` if writing was enabled.
+   */
+  MYWR_INLINE bool good() const {
+    return m_good;
+  }
+
+private:
+  pkey_domain& m_domain;
+  bool         m_was_writable;
+  bool         m_good;
+};
 } // namespace protect
 } // namespace mywr
 
@@ -0,0 +1,261 @@
+/*********************************************************************
+ * @file   scan.hpp
+ * @brief  Module containing the memory walker for scanners.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_SCAN_HPP_
+#define MYWR_SCAN_HPP_
+
+namespace mywr {
+/**
+ * @brief Namespace containing the memory walker.
+ *
+ * @details
+ * Every search over the process memory (byte patterns, values, strings) is
+ * bound by memory latency. @ref walk gives them one traversal: readable
+ * regions are cut into chunks, non-resident pages are skipped without
+ * faulting them in, and the memory ahead of the current chunk is
+ * prefetched while the callback scans it.
+ */
+namespace scan {
+/**
+ * @brief Contiguous readable memory delivered to the callback.
+ */
+struct chunk {
+  /**
+   * @brief The address of the first byte.
+   */
+  address_t address{};
+
+  /**
+   * @brief The bytes.
+   */
+  const byte_t* data{};
+
+  /**
+   * @brief The number of bytes.
+   */
+  std::size_t size{};
+
+  MYWR_INLINE const byte_t* begin() const {
+    return data;
+  }
+
+  MYWR_INLINE const byte_t* end() const {
+    return data + size;
+  }
+};
+
+/**
+ * @brief Options of @ref walk.
+ */
+struct walk_options {
+  /**
+   * @brief Maximum size of the chunk. Chunks end at region boundaries and
+   * skipped pages too.
+   */
+  std::size_t chunk_size = 16 * 1024;
+
+  /**
+   * @brief How far ahead of the chunk the memory is prefetched, in bytes.
+   * Zero disables prefetching.
+   */
+  std::size_t prefetch_distance = 64 * 1024;
+
+  /**
+   * @brief Skip pages not present in memory (`mincore`, Linux only). Reading
+   * them would fault them in: allocate zero pages or read files from disk.
+   * Pages of file mappings beyond the end of the file are never resident,
+   * without skipping reading them raises `SIGBUS`.
+   */
+  bool skip_non_resident = true;
+};
+
+namespace impl {
+/**
+ * @brief Number of pages whose residency is queried at once.
+ */
+constexpr std::size_t kResidencyWindow = 512;
+
+/**
+ * @brief Prefetches the memory area for reading.
+ */
+MYWR_INLINE void prefetch(address_t begin, address_t end) {
+  for (address_t line = begin & ~address_t{63}; line < end; line += 64) {
+#if defined(MYWR_FEATURE_STREAMING)
+    _mm_prefetch(reinterpret_cast<const char*>(line), _MM_HINT_T0);
+#elif defined(MYWR_GCC)
+    __builtin_prefetch(reinterpret_cast<const void*>(line), 0, 3);
+#endif
+  }
+}
+
+/**
+ * @brief Walks the readable area.
+ *
+ * @return `false` if the callback stopped the walk.
+ */
+template<typename Fn>
+bool walk_area(const address_range&        area,
+               Fn&                         invoke,
+               const walk_options&         options,
+               std::vector<unsigned char>& residency) {
+  const std::size_t page_size  = mywr::page_size();
+  const std::size_t chunk_size = options.chunk_size ? options.chunk_size
+                                                    : page_size;
+
+  // Delivers the resident run in chunks.
+  auto deliver = [&](address_t begin, address_t end) {
+    for (address_t address = begin; address < end;) {
+      address_t next = end - address > chunk_size ? address + chunk_size : end;
+
+      // Prefetch the chunk `prefetch_distance` ahead of this one.
+      if (options.prefetch_distance != 0) {
+        address_t ahead = std::max(address + options.prefetch_distance, next);
+        impl::prefetch(ahead, std::min<address_t>(ahead + chunk_size, end));
+      }
+
+      chunk piece{address,
+                  reinterpret_cast<const byte_t*>(address),
+                  static_cast<std::size_t>(next - address)};
+      if (!invoke(piece))
+        return false;
+      address = next;
+    }
+    return true;
+  };
+
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  if (options.skip_non_resident) {
+    residency.resize(kResidencyWindow);
+
+    address_range pages  = area.page_aligned();
+    std::size_t   window = kResidencyWindow * page_size;
+    for (address_t begin = pages.begin(); begin < pages.end();
+         begin += window) {
+      std::size_t length = std::min<std::size_t>(window, pages.end() - begin);
+
+      MYWR_STATS_COUNT(kSyscall);
+      void* pages_begin = reinterpret_cast<void*>(begin);
+      if (mincore(pages_begin, length, residency.data()) != 0)
+        continue;
+
+      // Deliver runs of resident pages.
+      std::size_t count = length / page_size;
+      for (std::size_t first = 0; first < count;) {
+        if (!(residency[first] & 1)) {
+          first++;
+          continue;
+        }
+
+        std::size_t last = first;
+        while (last < count && (residency[last] & 1))
+          last++;
+
+        address_range run =
+            address_range{begin + first * page_size, begin + last * page_size}
+                .intersection(area);
+        if (!run.empty() && !deliver(run.begin(), run.end()))
+          return false;
+        first = last;
+      }
+    }
+    return true;
+  }
+#else
+  static_cast<void>(residency);
+#endif
+
+  return deliver(area.begin(), area.end());
+}
+} // namespace impl
+
+/**
+ * @brief Calls `callback` for chunks of readable memory in the range, in
+ * address order.
+ *
+ * @details
+ * Regions without read access (guard pages) and `[vvar]` are skipped. The
+ * callback may return `bool`, `false` stops the walk. The memory may change
+ * or be unmapped by other threads while it is scanned.
+ *
+ * @code{.cpp}
+ * std::size_t found = 0;
+ * mywr::scan::walk(heap, [&](const mywr::scan::chunk& chunk) {
+ *   found += std::count(chunk.begin(), chunk.end(), 0xCC);
+ * });
+ * @endcode
+ *
+ * @param[in] range    The range to walk.
+ * @param[in] callback Callable taking `const chunk&`.
+ * @param[in] options  The options.
+ */
+template<typename Fn>
+static void walk(const address_range& range,
+                 Fn&&                 callback,
+                 const walk_options&  options = {}) {
+  auto invoke = [&callback](const chunk& piece) {
+    if constexpr (std::is_same_v<decltype(callback(piece)), bool>)
+      return callback(piece);
+    else
+      return callback(piece), true;
+  };
+
+  std::vector<unsigned char> residency;
+
+#if defined(MYWR_LINUX)
+  procfs::for_each_region(
+      [&](const procfs::memory_region& region) {
+        if (region.begin >= range.end())
+          return false;
+        if (!(region.permissions & PROT_READ) ||
+            region.pathname.rfind("[vvar", 0) == 0)
+          return true;
+
+        address_range area =
+            address_range{region.begin, region.end}.intersection(range);
+        return area.empty() ||
+               impl::walk_area(area, invoke, options, residency);
+      },
+      true);
+#elif defined(MYWR_WINDOWS)
+  MEMORY_BASIC_INFORMATION info{};
+  for (address_t address = range.begin(); address < range.end();) {
+    MYWR_STATS_COUNT(kSyscall);
+    if (!VirtualQuery(reinterpret_cast<LPCVOID>(address), &info, sizeof(info)))
+      return;
+    address = reinterpret_cast<address_t>(info.BaseAddress) + info.RegionSize;
+
+    constexpr DWORD kReadable = PAGE_READONLY | PAGE_READWRITE |
+                                PAGE_WRITECOPY | PAGE_EXECUTE_READ |
+                                PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+    if (info.State != MEM_COMMIT || !(info.Protect & kReadable) ||
+        (info.Protect & PAGE_GUARD))
+      continue;
+
+    address_t     begin = reinterpret_cast<address_t>(info.BaseAddress);
+    address_range area  = address_range::from_size(begin, info.RegionSize)
+                             .intersection(range);
+    if (!area.empty() && !impl::walk_area(area, invoke, options, residency))
+      return;
+  }
+#else
+  impl::walk_area(range, invoke, options, residency);
+#endif
+}
+
+/**
+ * @brief Calls `callback` for chunks of all readable memory of the process.
+ * See @ref walk on the range.
+ */
+template<typename Fn>
+static void walk(Fn&& callback, const walk_options& options = {}) {
+  walk(address_range{0, ~address_t{0}}, std::forward<Fn>(callback), options);
+}
+} // namespace scan
+} // namespace mywr
+
+#endif // !MYWR_SCAN_HPP_
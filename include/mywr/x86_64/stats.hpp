@@ -0,0 +1,303 @@
+/*********************************************************************
+ * @file   stats.hpp
+ * @brief  Module containing instrumentation counters of memory operations.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_STATS_HPP_
+#define MYWR_STATS_HPP_
+
+namespace mywr {
+/**
+ * @brief Namespace containing instrumentation counters.
+ *
+ * @details
+ * Counters are compiled in only with `MYWR_FEATURE_STATS` defined, otherwise
+ * every instrumentation point expands to nothing and @ref snapshot returns
+ * zeros. The define must be the same in all translation units.
+ */
+namespace stats {
+/**
+ * @brief Instrumented operations.
+ */
+enum counter : std::uint32_t {
+  kSetProtect,
+  kGetProtect,
+  kParseMaps,
+  kQueryRegion,
+  kFlush,
+  /**
+   * @brief Huge pages split by protection changes. Counted only when the
+   * huge page mode is not @ref protect::huge_page_mode::kIgnore.
+   */
+  kHugePageSplit,
+  /**
+   * @brief System calls made by all of the operations above and other
+   * modules (`mprotect`, `VirtualProtect`, `pread`, `ioctl`, ...).
+   */
+  kSyscall,
+  kCounterCount
+};
+
+/**
+ * @brief Aggregated values of all counters.
+ */
+struct counters {
+  /**
+   * @brief Number of calls of each operation.
+   */
+  std::uint64_t calls[kCounterCount]{};
+
+  /**
+   * @brief Total time spent in each operation. Zero for @ref kSyscall.
+   */
+  std::uint64_t nanoseconds[kCounterCount]{};
+};
+
+/**
+ * @brief Returns `true` if counters are compiled in.
+ */
+constexpr bool enabled() {
+#if defined(MYWR_FEATURE_STATS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if defined(MYWR_FEATURE_STATS)
+namespace impl {
+/**
+ * @brief Counters of one thread. Written only by the owning thread, so
+ * updates need no atomic read-modify-write.
+ */
+struct alignas(64) thread_counters {
+  std::atomic<std::uint64_t> calls[kCounterCount]{};
+  std::atomic<std::uint64_t> nanoseconds[kCounterCount]{};
+};
+
+/**
+ * @brief Registry of alive threads counters.
+ */
+struct registry {
+  std::mutex                    mutex;
+  std::vector<thread_counters*> threads;
+  counters                      retired{};
+  counters                      baseline{};
+};
+
+/**
+ * @brief Returns the process-wide registry. Never destroyed, so threads
+ * exiting after static destructors still may unregister.
+ */
+inline registry& get_registry() {
+  static registry* instance = new registry{};
+  return *instance;
+}
+
+/**
+ * @brief Registers the counters of the thread and folds them into the
+ * retired ones on the thread exit.
+ */
+struct thread_handle {
+  thread_counters counters;
+
+  thread_handle() {
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(&counters);
+  }
+
+  ~thread_handle() {
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (std::uint32_t i = 0; i < kCounterCount; i++) {
+      registry.retired.calls[i] += counters.calls[i].load();
+      registry.retired.nanoseconds[i] += counters.nanoseconds[i].load();
+    }
+
+    auto& threads = registry.threads;
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+      if (*it == &counters) {
+        threads.erase(it);
+        break;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Returns the counters of the calling thread.
+ */
+MYWR_INLINE thread_counters& local() {
+  static thread_local thread_handle handle;
+  return handle.counters;
+}
+
+/**
+ * @brief Adds the value to the single-writer counter.
+ */
+MYWR_INLINE void add(std::atomic<std::uint64_t>& value, std::uint64_t delta) {
+  value.store(value.load(std::memory_order_relaxed) + delta,
+              std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sums counters of all threads, without the baseline.
+ */
+inline counters total(registry& registry) {
+  counters result = registry.retired;
+  for (auto* thread : registry.threads) {
+    for (std::uint32_t i = 0; i < kCounterCount; i++) {
+      result.calls[i] += thread->calls[i].load(std::memory_order_relaxed);
+      result.nanoseconds[i] +=
+          thread->nanoseconds[i].load(std::memory_order_relaxed);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Returns the monotonic time in nanoseconds.
+ */
+MYWR_INLINE std::uint64_t now() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+} // namespace impl
+#endif
+
+/**
+ * @brief Counts the call of the operation in the calling thread.
+ *
+ * @param[in] counter The operation.
+ * @param[in] calls   The number of calls.
+ */
+MYWR_INLINE void count([[maybe_unused]] const counter       counter,
+                       [[maybe_unused]] const std::uint64_t calls = 1) {
+#if defined(MYWR_FEATURE_STATS)
+  impl::add(impl::local().calls[counter], calls);
+#endif
+}
+
+/**
+ * @brief Counts the call of the operation and the time spent in it.
+ *
+ * @param[in] counter     The operation.
+ * @param[in] nanoseconds The time spent.
+ */
+MYWR_INLINE void record([[maybe_unused]] const counter       counter,
+                        [[maybe_unused]] const std::uint64_t nanoseconds) {
+#if defined(MYWR_FEATURE_STATS)
+  impl::thread_counters& local = impl::local();
+  impl::add(local.calls[counter], 1);
+  impl::add(local.nanoseconds[counter], nanoseconds);
+#endif
+}
+
+/**
+ * @brief Aggregates counters of all threads since the last @ref reset.
+ *
+ * @code{.cpp}
+ * auto before = mywr::stats::snapshot();
+ * mywr::llmo::write<int>(0xDEADBEEF, 1);
+ * auto after = mywr::stats::snapshot();
+ *
+ * auto syscalls = after.calls[mywr::stats::kSyscall] -
+ *                 before.calls[mywr::stats::kSyscall];
+ * @endcode
+ */
+inline counters snapshot() {
+#if defined(MYWR_FEATURE_STATS)
+  auto&                       registry = impl::get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  counters result = impl::total(registry);
+  for (std::uint32_t i = 0; i < kCounterCount; i++) {
+    result.calls[i] -= registry.baseline.calls[i];
+    result.nanoseconds[i] -= registry.baseline.nanoseconds[i];
+  }
+  return result;
+#else
+  return {};
+#endif
+}
+
+/**
+ * @brief Resets all counters to zero.
+ *
+ * @details
+ * Per-thread counters are never written by other threads, so the reset only
+ * remembers current values as the new baseline.
+ */
+inline void reset() {
+#if defined(MYWR_FEATURE_STATS)
+  auto&                       registry = impl::get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  registry.baseline = impl::total(registry);
+#endif
+}
+
+#if defined(MYWR_FEATURE_STATS)
+/**
+ * @brief RAII timer counting the call of the operation and its duration.
+ */
+class scoped_timer {
+public:
+  /**
+   * @brief Main constructor. Starts the timer.
+   *
+   * @param[in] counter The operation.
+   */
+  explicit scoped_timer(const counter counter)
+      : m_counter(counter)
+      , m_begin(impl::now()) {}
+
+  /**
+   * @brief Destructor. Records the duration.
+   */
+  ~scoped_timer() {
+    record(m_counter, impl::now() - m_begin);
+  }
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  scoped_timer(const scoped_timer&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const scoped_timer&) = delete;
+
+private:
+  /**
+   * @brief The operation.
+   */
+  counter m_counter;
+
+  /**
+   * @brief The begin of the operation.
+   */
+  std::uint64_t m_begin;
+};
+#endif
+} // namespace stats
+} // namespace mywr
+
+#if defined(MYWR_FEATURE_STATS)
+  #define MYWR_STATS_COUNT(counter) ::mywr::stats::count(::mywr::stats::counter)
+  #define MYWR_STATS_TIMER(counter)                                            \
+    ::mywr::stats::scoped_timer mywr_stats_timer(::mywr::stats::counter)
+#else
+  #define MYWR_STATS_COUNT(counter) static_cast<void>(0)
+  #define MYWR_STATS_TIMER(counter) static_cast<void>(0)
+#endif
+
+#endif // !MYWR_STATS_HPP_
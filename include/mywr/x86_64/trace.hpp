@@ -0,0 +1,464 @@
+/*********************************************************************
+ * @file   trace.hpp
+ * @brief  Module containing the trace of expensive operations.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_TRACE_HPP_
+#define MYWR_TRACE_HPP_
+
+namespace mywr {
+/**
+ * @brief Namespace containing the trace of expensive operations.
+ *
+ * @details
+ * With `MYWR_FEATURE_TRACE` defined, maps parsing, protection changes, bulk
+ * copies and fills and disassembly of ranges record their begin and end into
+ * the ring buffer of the calling thread. @ref dump exports the buffers in the
+ * Chrome trace format (`chrome://tracing`, Perfetto). Recording takes no
+ * locks: the thread writes the event and publishes it by one store.
+ * Timestamps come from `rdtsc` where available, which assumes the invariant
+ * TSC of modern CPUs.
+ *
+ * Without the define every instrumentation point expands to nothing, its
+ * arguments aren't evaluated, and @ref dump returns an empty trace. The
+ * define must be the same in all translation units.
+ */
+namespace trace {
+/**
+ * @brief Number of the last events kept per thread.
+ */
+constexpr std::size_t kCapacity = 4096;
+
+/**
+ * @brief Returns `true` if tracing is compiled in.
+ */
+constexpr bool enabled() {
+#if defined(MYWR_FEATURE_TRACE)
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if defined(MYWR_FEATURE_TRACE)
+namespace impl {
+/**
+ * @brief Recorded operation. Fields are atomic because @ref dump may read
+ * the slot while the owning thread overwrites it.
+ */
+struct event {
+  std::atomic<const char*>   name{};
+  std::atomic<std::uint64_t> begin{};
+  std::atomic<std::uint64_t> end{};
+  std::atomic<std::uint64_t> size{};
+};
+
+/**
+ * @brief Ring buffer of one thread. Written only by the owning thread.
+ */
+struct thread_buffer {
+  event events[kCapacity];
+
+  /**
+   * @brief Number of events ever recorded, published with release order.
+   */
+  alignas(64) std::atomic<std::uint64_t> head{};
+
+  /**
+   * @brief Value of @ref head at the last @ref clear.
+   */
+  std::atomic<std::uint64_t> floor{};
+
+  /**
+   * @brief The thread id shown in the trace.
+   */
+  std::uint64_t thread_id{};
+
+  /**
+   * @brief `true` once the thread exited. Guarded by the registry mutex.
+   */
+  bool retired{};
+};
+
+/**
+ * @brief Registry of the buffers. Buffers of exited threads are kept until
+ * @ref clear, so their events still get into the dump.
+ */
+struct registry {
+  std::mutex                                  mutex;
+  std::vector<std::unique_ptr<thread_buffer>> buffers;
+
+  /**
+   * @brief Timestamp and steady clock at the first registration, to convert
+   * timestamps to time.
+   */
+  std::uint64_t origin_ticks{};
+  std::uint64_t origin_ns{};
+};
+
+/**
+ * @brief Returns the process-wide registry. Never destroyed, so threads
+ * exiting after static destructors still may retire their buffers.
+ */
+inline registry& get_registry() {
+  static registry* instance = new registry{};
+  return *instance;
+}
+
+/**
+ * @brief Returns the timestamp counter.
+ */
+MYWR_INLINE std::uint64_t ticks() {
+#if defined(MYWR_FEATURE_RDTSC)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+/**
+ * @brief Returns the monotonic time in nanoseconds.
+ */
+MYWR_INLINE std::uint64_t now() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+/**
+ * @brief Returns the id of the calling thread.
+ */
+inline std::uint64_t current_thread_id() {
+#if defined(MYWR_WINDOWS)
+  return GetCurrentThreadId();
+#elif defined(MYWR_LINUX)
+  return static_cast<std::uint64_t>(syscall(SYS_gettid));
+#else
+  return std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+}
+
+/**
+ * @brief Returns the id of the process.
+ */
+inline std::uint64_t current_process_id() {
+#if defined(MYWR_WINDOWS)
+  return GetCurrentProcessId();
+#else
+  return static_cast<std::uint64_t>(getpid());
+#endif
+}
+
+/**
+ * @brief Registers the buffer of the thread and retires it on the thread
+ * exit.
+ */
+struct thread_handle {
+  thread_buffer* buffer;
+
+  thread_handle() {
+    auto owned = std::make_unique<thread_buffer>();
+
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    if (registry.buffers.empty() && registry.origin_ns == 0) {
+      registry.origin_ticks = ticks();
+      registry.origin_ns    = now();
+    }
+
+    owned->thread_id = current_thread_id();
+    buffer           = owned.get();
+    registry.buffers.push_back(std::move(owned));
+  }
+
+  ~thread_handle() {
+    auto&                       registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    buffer->retired = true;
+  }
+};
+
+/**
+ * @brief Returns the buffer of the calling thread.
+ */
+MYWR_INLINE thread_buffer& local() {
+  static thread_local thread_handle handle;
+  return *handle.buffer;
+}
+
+/**
+ * @brief Records the operation into the buffer of the calling thread.
+ */
+MYWR_INLINE void record(thread_buffer& buffer,
+                        const char*    name,
+                        std::uint64_t  begin,
+                        std::uint64_t  end,
+                        std::uint64_t  size) {
+  std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  event&        slot = buffer.events[head & (kCapacity - 1)];
+
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.begin.store(begin, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+  slot.size.store(size, std::memory_order_relaxed);
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Appends the string as a JSON string literal.
+ */
+inline void append_quoted(std::string& out, const char* text) {
+  out += '"';
+  for (; *text; text++) {
+    if (*text == '"' || *text == '\\')
+      out += '\\';
+    out += *text;
+  }
+  out += '"';
+}
+
+/**
+ * @brief Appends events of the buffer in the Chrome trace format.
+ *
+ * @param[in] ns_per_tick Duration of one tick.
+ * @param[in] idle        `true` if the buffer isn't written meanwhile: it
+ * belongs to the calling thread or to an exited one.
+ */
+inline void append_events(std::string&         out,
+                          const thread_buffer& buffer,
+                          const registry&      registry,
+                          double               ns_per_tick,
+                          std::uint64_t        pid,
+                          bool                 idle) {
+  static_assert((kCapacity & (kCapacity - 1)) == 0,
+                "capacity must be a power of two");
+
+  std::uint64_t head  = buffer.head.load(std::memory_order_acquire);
+  std::uint64_t first = head > kCapacity ? head - kCapacity : 0;
+  first = std::max(first, buffer.floor.load(std::memory_order_relaxed));
+
+  struct copied {
+    const char*   name;
+    std::uint64_t begin, end, size;
+  };
+
+  std::vector<copied> events;
+  events.reserve(static_cast<std::size_t>(head - first));
+  for (std::uint64_t i = first; i < head; i++) {
+    const event& slot = buffer.events[i & (kCapacity - 1)];
+    events.push_back({slot.name.load(std::memory_order_relaxed),
+                      slot.begin.load(std::memory_order_relaxed),
+                      slot.end.load(std::memory_order_relaxed),
+                      slot.size.load(std::memory_order_relaxed)});
+  }
+
+  // Drop the events the thread may have overwritten while they were copied,
+  // including the slot of the event being recorded right now.
+  std::size_t skip = 0;
+  if (!idle) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t last = buffer.head.load(std::memory_order_relaxed) + 1;
+    if (last > first + kCapacity)
+      skip = static_cast<std::size_t>(
+          std::min<std::uint64_t>(last - kCapacity - first, events.size()));
+  }
+
+  char number[96];
+  for (std::size_t i = skip; i < events.size(); i++) {
+    const copied& event = events[i];
+    if (event.name == nullptr || event.begin < registry.origin_ticks)
+      continue;
+
+    double ts =
+        static_cast<double>(event.begin - registry.origin_ticks) * ns_per_tick;
+    double duration =
+        static_cast<double>(event.end - event.begin) * ns_per_tick;
+
+    if (out.back() == '}')
+      out += ",";
+    out += "\n{\"name\":";
+    append_quoted(out, event.name);
+    std::snprintf(number,
+                  sizeof(number),
+                  ",\"cat\":\"mywr\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                  ts / 1000.0,
+                  duration / 1000.0);
+    out += number;
+    std::snprintf(number,
+                  sizeof(number),
+                  ",\"pid\":%llu,\"tid\":%llu",
+                  static_cast<unsigned long long>(pid),
+                  static_cast<unsigned long long>(buffer.thread_id));
+    out += number;
+    if (event.size != 0) {
+      std::snprintf(number,
+                    sizeof(number),
+                    ",\"args\":{\"size\":%llu}",
+                    static_cast<unsigned long long>(event.size));
+      out += number;
+    }
+    out += "}";
+  }
+}
+} // namespace impl
+#endif
+
+/**
+ * @brief Exports the recorded events of all threads as Chrome trace JSON.
+ *
+ * @details
+ * Threads may keep recording while the trace is dumped, events they
+ * overwrite meanwhile are left out.
+ *
+ * @code{.cpp}
+ * std::ofstream{"mywr.json"} << mywr::trace::dump();
+ * @endcode
+ *
+ * @return The JSON document.
+ */
+inline std::string dump() {
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+#if defined(MYWR_FEATURE_TRACE)
+  auto&                       registry = impl::get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  // Calibrate ticks against the steady clock over at least a millisecond.
+  std::uint64_t ticks = impl::ticks();
+  std::uint64_t ns    = impl::now();
+  while (ns - registry.origin_ns < 1000000) {
+    std::this_thread::yield();
+    ticks = impl::ticks();
+    ns    = impl::now();
+  }
+
+  double ns_per_tick = static_cast<double>(ns - registry.origin_ns) /
+                       static_cast<double>(ticks - registry.origin_ticks);
+
+  std::uint64_t pid = impl::current_process_id();
+  std::uint64_t tid = impl::current_thread_id();
+  for (const auto& buffer : registry.buffers) {
+    bool idle = buffer->retired || buffer->thread_id == tid;
+    impl::append_events(out, *buffer, registry, ns_per_tick, pid, idle);
+  }
+#endif
+
+  out += "\n]}\n";
+  return out;
+}
+
+/**
+ * @brief Writes the trace to the file.
+ *
+ * @param[in] path The path of the file.
+ *
+ * @return `true` if the file was written.
+ */
+inline bool dump(const std::filesystem::path& path) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return false;
+
+  file << dump();
+  return static_cast<bool>(file);
+}
+
+/**
+ * @brief Forgets recorded events and frees buffers of exited threads.
+ */
+inline void clear() {
+#if defined(MYWR_FEATURE_TRACE)
+  auto&                       registry = impl::get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto& buffers = registry.buffers;
+  buffers.erase(std::remove_if(buffers.begin(),
+                               buffers.end(),
+                               [](const auto& buffer) {
+                                 return buffer->retired;
+                               }),
+                buffers.end());
+
+  for (auto& buffer : buffers)
+    buffer->floor.store(buffer->head.load(std::memory_order_acquire),
+                        std::memory_order_relaxed);
+#endif
+}
+
+#if defined(MYWR_FEATURE_TRACE)
+/**
+ * @brief RAII recorder of the operation.
+ */
+class scoped_event {
+public:
+  /**
+   * @brief Main constructor. Remembers the begin.
+   *
+   * @param[in] name The operation, must be a string with static storage.
+   * @param[in] size The number of bytes processed, zero if none.
+   */
+  scoped_event(const char* name, std::uint64_t size)
+      : m_buffer(impl::local())
+      , m_name(name)
+      , m_size(size)
+      , m_begin(impl::ticks()) {}
+
+  /**
+   * @brief Destructor. Records the operation.
+   */
+  ~scoped_event() {
+    impl::record(m_buffer, m_name, m_begin, impl::ticks(), m_size);
+  }
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  scoped_event(const scoped_event&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const scoped_event&) = delete;
+
+private:
+  /**
+   * @brief The buffer of the calling thread.
+   */
+  impl::thread_buffer& m_buffer;
+
+  /**
+   * @brief The operation.
+   */
+  const char* m_name;
+
+  /**
+   * @brief The number of bytes processed.
+   */
+  std::uint64_t m_size;
+
+  /**
+   * @brief The begin of the operation.
+   */
+  std::uint64_t m_begin;
+};
+#endif
+} // namespace trace
+} // namespace mywr
+
+#if defined(MYWR_FEATURE_TRACE)
+  #define MYWR_TRACE_SCOPE(name, size)                                         \
+    ::mywr::trace::scoped_event mywr_trace_event(                              \
+        name, static_cast<std::uint64_t>(size))
+#else
+  #define MYWR_TRACE_SCOPE(name, size) static_cast<void>(0)
+#endif
+
+#endif // !MYWR_TRACE_HPP_
@@ -0,0 +1,1006 @@
+/*********************************************************************
+ * @file   watch.hpp
+ * @brief  Module containing tools for watching memory regions for writes.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_WATCH_HPP_
+#define MYWR_WATCH_HPP_
+
+namespace mywr {
+/**
+ * @brief Namespace containing tools for watching memory regions for writes.
+ */
+namespace watch {
+/**
+ * @brief Data-structure describing single write caught by the watcher.
+ */
+struct write_record {
+  /**
+   * @brief The address that was written to. With `userfaultfd` backend it is
+   * aligned to the page.
+   */
+  address_t address{};
+
+  /**
+   * @brief The instruction pointer of the writer. Zero if the backend can't
+   * provide it (`userfaultfd`).
+   */
+  address_t ip{};
+
+  /**
+   * @brief The identifier of the thread that produced the write. Zero if
+   * unknown.
+   */
+  std::uint32_t tid{};
+};
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer ring buffer.
+ *
+ * @details
+ * Based on Dmitry Vyukov's bounded MPMC queue. It never allocates after the
+ * construction and never blocks, so it is safe to push into it from signal
+ * handlers. When the buffer is full, new values are dropped and counted.
+ *
+ * @tparam T Trivially copyable type of stored values.
+ */
+template<typename T>
+class ring_buffer {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ring_buffer requires trivially copyable type");
+
+public:
+  /**
+   * @brief Constructor. `capacity` is rounded up to the power of two.
+   */
+  explicit ring_buffer(std::size_t capacity) {
+    std::size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+
+    m_cells = std::make_unique<cell[]>(size);
+    m_mask  = size - 1;
+
+    for (std::size_t i = 0; i < size; ++i)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pushes the value into the buffer.
+   * @return `false` if the buffer is full and the value was dropped.
+   */
+  bool push(const T& value) {
+    std::size_t pos = m_enqueue.load(std::memory_order_relaxed);
+    for (;;) {
+      cell&          c   = m_cells[pos & m_mask];
+      std::size_t    seq = c.sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) -
+                           static_cast<std::ptrdiff_t>(pos);
+      if (dif == 0) {
+        if (m_enqueue.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          c.value = value;
+          c.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Pops the oldest value from the buffer.
+   * @return `false` if the buffer is empty.
+   */
+  bool pop(T& value) {
+    std::size_t pos = m_dequeue.load(std::memory_order_relaxed);
+    for (;;) {
+      cell&          c   = m_cells[pos & m_mask];
+      std::size_t    seq = c.sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) -
+                           static_cast<std::ptrdiff_t>(pos + 1);
+      if (dif == 0) {
+        if (m_dequeue.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          value = c.value;
+          c.sequence.store(pos + m_mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the number of values dropped due to overflow.
+   */
+  std::size_t dropped() const {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct cell {
+    std::atomic<std::size_t> sequence{};
+    T                        value{};
+  };
+
+  std::unique_ptr<cell[]> m_cells{};
+  std::size_t             m_mask{};
+
+  alignas(64) std::atomic<std::size_t> m_enqueue{0};
+  alignas(64) std::atomic<std::size_t> m_dequeue{0};
+  alignas(64) std::atomic<std::size_t> m_dropped{0};
+};
+
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+namespace impl {
+/**
+ * @brief Fault callback. Must be async-signal-safe. Returns `true` if the
+ * fault was handled and the faulting instruction may be restarted.
+ */
+using fault_callback = bool (*)(void* context, address_t address, address_t ip);
+
+/**
+ * @brief Slot of the process-wide fault dispatch table.
+ */
+struct fault_slot {
+  std::atomic<void*>         context{nullptr};
+  std::atomic<bool>          active{false};
+  std::atomic<std::uint32_t> users{0};
+  address_t                  begin{};
+  address_t                  end{};
+  fault_callback             callback{};
+};
+
+constexpr std::size_t kMaxFaultSlots = 64;
+
+inline fault_slot       g_fault_slots[kMaxFaultSlots];
+inline struct sigaction g_previous_action{};
+inline std::once_flag   g_handler_once{};
+
+/**
+ * @brief Returns the instruction pointer stored in the signal context.
+ */
+MYWR_INLINE address_t instruction_pointer(void* ucontext) {
+  auto* context = static_cast<ucontext_t*>(ucontext);
+  #if defined(MYWR_X64)
+  return static_cast<address_t>(context->uc_mcontext.gregs[REG_RIP]);
+  #else
+  return static_cast<address_t>(context->uc_mcontext.gregs[REG_EIP]);
+  #endif
+}
+
+/**
+ * @brief SIGSEGV handler. Dispatches the fault to the registered range, or
+ * chains to the previously installed handler.
+ */
+inline void on_fault_signal(int sig, siginfo_t* info, void* ucontext) {
+  address_t address = reinterpret_cast<address_t>(info->si_addr);
+  address_t ip      = instruction_pointer(ucontext);
+
+  for (auto& slot : g_fault_slots) {
+    slot.users.fetch_add(1, std::memory_order_acquire);
+
+    bool handled = slot.active.load(std::memory_order_acquire) &&
+                   address >= slot.begin && address < slot.end &&
+                   slot.callback(slot.context.load(std::memory_order_relaxed),
+                                 address,
+                                 ip);
+
+    slot.users.fetch_sub(1, std::memory_order_release);
+
+    if (handled)
+      return;
+  }
+
+  /**
+   * Not our fault, give it to the previous handler.
+   */
+  if (g_previous_action.sa_flags & SA_SIGINFO) {
+    g_previous_action.sa_sigaction(sig, info, ucontext);
+  } else if (g_previous_action.sa_handler == SIG_DFL ||
+             g_previous_action.sa_handler == SIG_IGN) {
+    // Restore the default action, the instruction will fault again.
+    sigaction(sig, &g_previous_action, nullptr);
+  } else {
+    g_previous_action.sa_handler(sig);
+  }
+}
+
+/**
+ * @brief Installs the SIGSEGV handler once per process.
+ */
+inline void install_fault_handler() {
+  std::call_once(g_handler_once, [] {
+    struct sigaction action{};
+    action.sa_sigaction = on_fault_signal;
+    action.sa_flags     = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+
+    sigaction(SIGSEGV, &action, &g_previous_action);
+  });
+}
+
+/**
+ * @brief Registers the range in the fault dispatch table.
+ * @return Occupied slot or `nullptr` if the table is full.
+ */
+inline fault_slot* register_fault_range(address_t      begin,
+                                        address_t      end,
+                                        fault_callback callback,
+                                        void*          context) {
+  install_fault_handler();
+
+  for (auto& slot : g_fault_slots) {
+    void* expected = nullptr;
+    if (!slot.context.compare_exchange_strong(expected, context))
+      continue;
+
+    slot.begin    = begin;
+    slot.end      = end;
+    slot.callback = callback;
+    slot.active.store(true, std::memory_order_release);
+    return &slot;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Removes the range from the fault dispatch table and waits until no
+ * signal handler uses it.
+ */
+inline void unregister_fault_range(fault_slot* slot) {
+  if (!slot)
+    return;
+
+  slot->active.store(false, std::memory_order_release);
+  while (slot->users.load(std::memory_order_acquire) != 0)
+    std::this_thread::yield();
+
+  slot->context.store(nullptr, std::memory_order_release);
+}
+} // namespace impl
+#endif
+
+/**
+ * @class region
+ * @brief Watches the memory region for writes.
+ *
+ * @details
+ * Every first write to a page of the watched region is caught, recorded into
+ * the lock-free ring buffer and then the page becomes writable again, so the
+ * writer continues normally. Call @ref region::rearm() to catch the next
+ * writes. Memory outside of the watched pages is never touched, so it has no
+ * overhead at all.
+ *
+ * Two backends are available:
+ * - `userfaultfd` in write-protect mode (`UFFDIO_WRITEPROTECT`). Faults are
+ * resolved by the handler thread. Supported only for anonymous memory, the
+ * instruction pointer is unknown.
+ * - `mprotect` + SIGSEGV. Works for any writable mapping, records the
+ * instruction pointer of the writer. Every page of the range must have the
+ * same protection, otherwise the backend isn't used.
+ *
+ * @code{.cpp}
+ * mywr::watch::region watcher{&g_config, sizeof(g_config)};
+ *
+ * // ... later
+ * mywr::watch::write_record record;
+ * while (watcher.pop(record))
+ *   printf("%p written by %p\n", (void*)record.address, (void*)record.ip);
+ * @endcode
+ */
+class region {
+public:
+  /**
+   * @brief Backends of the watcher.
+   */
+  enum backend_type : std::uint32_t {
+    kNone,
+    kAuto,
+    kUserfaultfd,
+    kMprotect
+  };
+
+  /**
+   * @name Constructors & Destructor.
+   * @{
+   */
+
+  /**
+   * @brief Default constructor forbidden.
+   */
+  region() = delete;
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  region(const region&) = delete;
+
+  /**
+   * @brief Move constructor forbidden.
+   */
+  region(region&&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const region&) = delete;
+
+  /**
+   * @brief Move operator forbidden.
+   */
+  void operator=(region&&) = delete;
+
+  /**
+   * @brief Main constructor. Starts watching.
+   *
+   * @param[in] target   The begin of the memory region to watch.
+   * @param[in] size     The size of the memory region to watch.
+   * @param[in] capacity Capacity of the ring buffer with records.
+   * @param[in] backend  The preferred backend. @ref kAuto tries `userfaultfd`
+   * first and falls back to `mprotect`.
+   */
+  region(const address&    target,
+         const std::size_t size,
+         const std::size_t capacity = 1024,
+         const backend_type backend = kAuto)
+      : m_records(capacity) {
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+    address_range area = address_range::from_size(target, size).page_aligned();
+
+    m_begin         = target.value();
+    m_end           = m_begin + size;
+    m_aligned_begin = area.begin();
+    m_aligned_end   = area.end();
+    m_page_size     = static_cast<address_t>(page_size());
+
+  #if !defined(MYWR_FEATURE_NO_USERFAULTFD)
+    if ((backend == kAuto || backend == kUserfaultfd) && init_userfaultfd()) {
+      m_backend = kUserfaultfd;
+      return;
+    }
+  #endif
+
+    if ((backend == kAuto || backend == kMprotect) && init_mprotect())
+      m_backend = kMprotect;
+#endif
+  }
+
+  /**
+   * @brief Destructor. Stops watching and restores memory protection.
+   */
+  ~region() {
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  #if !defined(MYWR_FEATURE_NO_USERFAULTFD)
+    if (m_backend == kUserfaultfd) {
+      uffdio_range range{m_aligned_begin, m_aligned_end - m_aligned_begin};
+      ioctl(m_uffd, UFFDIO_UNREGISTER, &range);
+
+      std::uint64_t stop = 1;
+      ::write(m_stop_fd, &stop, sizeof(stop));
+      m_thread.join();
+
+      ::close(m_stop_fd);
+      ::close(m_uffd);
+    }
+  #endif
+
+    if (m_backend == kMprotect) {
+      mprotect(reinterpret_cast<void*>(m_aligned_begin),
+               m_aligned_end - m_aligned_begin,
+               m_original);
+      impl::unregister_fault_range(m_slot);
+    }
+#endif
+  }
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Public Member Functions
+   * @{
+   */
+
+  /**
+   * @brief Returns `true` if the region is watched.
+   */
+  MYWR_INLINE bool good() const {
+    return m_backend != kNone;
+  }
+
+  /**
+   * @brief Returns the backend used to watch the region.
+   */
+  MYWR_INLINE backend_type backend() const {
+    return m_backend;
+  }
+
+  /**
+   * @brief Pops the oldest write record.
+   * @return `false` if there are no records.
+   */
+  MYWR_INLINE bool pop(write_record& record) {
+    return m_records.pop(record);
+  }
+
+  /**
+   * @brief Returns the number of records dropped due to full ring buffer.
+   */
+  MYWR_INLINE std::size_t dropped() const {
+    return m_records.dropped();
+  }
+
+  /**
+   * @brief Write-protects the whole region again, so next writes will be
+   * recorded.
+   */
+  bool rearm() {
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  #if !defined(MYWR_FEATURE_NO_USERFAULTFD)
+    if (m_backend == kUserfaultfd)
+      return write_protect(
+          m_aligned_begin, m_aligned_end - m_aligned_begin, true);
+  #endif
+
+    if (m_backend == kMprotect)
+      return mprotect(reinterpret_cast<void*>(m_aligned_begin),
+                      m_aligned_end - m_aligned_begin,
+                      m_original & ~PROT_WRITE) == 0;
+#endif
+    return false;
+  }
+
+  /**
+   * @}
+   */
+
+private:
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  /**
+   * @brief Records the write if [address, address + size) hits the watched
+   * range, not only the watched pages.
+   */
+  void record(address_t     address,
+              address_t     size,
+              address_t     ip,
+              std::uint32_t tid) {
+    if (address + size > m_begin && address < m_end)
+      m_records.push(write_record{address, ip, tid});
+  }
+
+  #if !defined(MYWR_FEATURE_NO_USERFAULTFD)
+  /**
+   * @brief Sets or clears write-protection of the range via `userfaultfd`.
+   */
+  bool write_protect(address_t begin, std::size_t size, bool enable) {
+    uffdio_writeprotect wp{};
+    wp.range.start = begin;
+    wp.range.len   = size;
+    wp.mode        = enable ? UFFDIO_WRITEPROTECT_MODE_WP : 0;
+    return ioctl(m_uffd, UFFDIO_WRITEPROTECT, &wp) == 0;
+  }
+
+  /**
+   * @brief Tries to initialize `userfaultfd` backend.
+   */
+  bool init_userfaultfd() {
+    if (!(protect::from_protection_constant(protect::get_protect(m_begin)) &
+          PROT_WRITE))
+      return false;
+
+    m_uffd =
+        static_cast<int>(syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK));
+    if (m_uffd < 0)
+      return false;
+
+    uffdio_api api{};
+    api.api      = UFFD_API;
+    api.features = UFFD_FEATURE_PAGEFAULT_FLAG_WP | UFFD_FEATURE_THREAD_ID;
+
+    uffdio_register reg{};
+    reg.range.start = m_aligned_begin;
+    reg.range.len   = m_aligned_end - m_aligned_begin;
+    reg.mode        = UFFDIO_REGISTER_MODE_WP;
+
+    if (ioctl(m_uffd, UFFDIO_API, &api) != 0 ||
+        ioctl(m_uffd, UFFDIO_REGISTER, &reg) != 0) {
+      ::close(m_uffd);
+      return false;
+    }
+
+    /**
+     * Populate the pages, write-protection of unpopulated pages isn't
+     * supported by older kernels. Atomic `or` with zero doesn't change data.
+     */
+    for (address_t page : address_range{m_aligned_begin, m_aligned_end}.pages())
+      __atomic_fetch_or(reinterpret_cast<byte_t*>(page), 0, __ATOMIC_RELAXED);
+
+    m_stop_fd = eventfd(0, EFD_CLOEXEC);
+    if (m_stop_fd < 0 || !write_protect(m_aligned_begin,
+                                        m_aligned_end - m_aligned_begin,
+                                        true)) {
+      ioctl(m_uffd, UFFDIO_UNREGISTER, &reg.range);
+      if (m_stop_fd >= 0)
+        ::close(m_stop_fd);
+      ::close(m_uffd);
+      return false;
+    }
+
+    m_thread = std::thread{&region::handler_thread, this};
+    return true;
+  }
+
+  /**
+   * @brief Handler thread. Records faults and removes write-protection from
+   * the faulted pages, which wakes the writers.
+   */
+  void handler_thread() {
+    pollfd fds[2]{
+        {m_uffd,    POLLIN, 0},
+        {m_stop_fd, POLLIN, 0}
+    };
+
+    for (;;) {
+      if (poll(fds, 2, -1) < 0)
+        continue;
+
+      if (fds[1].revents & POLLIN)
+        return;
+
+      uffd_msg msg{};
+      if (::read(m_uffd, &msg, sizeof(msg)) != sizeof(msg))
+        continue;
+
+      if (msg.event != UFFD_EVENT_PAGEFAULT)
+        continue;
+
+      address_t fault = static_cast<address_t>(msg.arg.pagefault.address);
+      address_t page  = fault & ~(m_page_size - 1u);
+
+      if (msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WP) {
+        record(page, m_page_size, 0, msg.arg.pagefault.feat.ptid);
+        write_protect(page, m_page_size, false);
+      } else {
+        uffdio_range range{page, m_page_size};
+        ioctl(m_uffd, UFFDIO_WAKE, &range);
+      }
+    }
+  }
+  #endif
+
+  /**
+   * @brief Tries to initialize `mprotect` backend.
+   */
+  bool init_mprotect() {
+    /**
+     * One protection is restored over the whole range, so every page must
+     * share it. Walk the mappings covering the range, not the pages.
+     */
+    for (address_t page = m_aligned_begin; page < m_aligned_end;) {
+      procfs::memory_region mapping{};
+      if (!procfs::query_region(page, mapping) || mapping.begin > page)
+        return false;
+
+      if (page == m_aligned_begin)
+        m_original = mapping.permissions;
+      else if (mapping.permissions != m_original)
+        return false;
+
+      page = mapping.end;
+    }
+
+    if (!(m_original & PROT_WRITE))
+      return false;
+
+    m_slot = impl::register_fault_range(
+        m_aligned_begin, m_aligned_end, &region::on_fault, this);
+    if (!m_slot)
+      return false;
+
+    if (mprotect(reinterpret_cast<void*>(m_aligned_begin),
+                 m_aligned_end - m_aligned_begin,
+                 m_original & ~PROT_WRITE) != 0) {
+      impl::unregister_fault_range(m_slot);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Fault callback of `mprotect` backend. Runs inside the signal
+   * handler.
+   */
+  static bool on_fault(void* context, address_t address, address_t ip) {
+    auto*     self = static_cast<region*>(context);
+    address_t page = address & ~(self->m_page_size - 1u);
+
+    self->record(
+        address, 1, ip, static_cast<std::uint32_t>(syscall(SYS_gettid)));
+
+    return mprotect(reinterpret_cast<void*>(page),
+                    self->m_page_size,
+                    self->m_original) == 0;
+  }
+#endif
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief Recorded writes.
+   */
+  ring_buffer<write_record> m_records;
+
+  /**
+   * @brief Used backend.
+   */
+  backend_type m_backend{kNone};
+
+  /**
+   * @brief The watched range as passed by user.
+   */
+  address_t m_begin{};
+  address_t m_end{};
+
+  /**
+   * @brief The watched range aligned to pages.
+   */
+  address_t m_aligned_begin{};
+  address_t m_aligned_end{};
+  address_t m_page_size{};
+
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  /**
+   * @brief Original OS-specific protection of the region (`mprotect` backend).
+   */
+  std::uint32_t m_original{};
+
+  /**
+   * @brief Slot in the fault dispatch table (`mprotect` backend).
+   */
+  impl::fault_slot* m_slot{};
+
+  /**
+   * @brief `userfaultfd` descriptor, stop event and handler thread.
+   */
+  int         m_uffd{-1};
+  int         m_stop_fd{-1};
+  std::thread m_thread{};
+#endif
+
+  /**
+   * @}
+   */
+};
+
+/**
+ * @brief Data-structure describing the first touch of the sampled page.
+ */
+struct page_access {
+  /**
+   * @brief The begin of the sampled page.
+   */
+  address_t page{};
+
+  /**
+   * @brief Was the page touched while sampling?
+   */
+  bool touched{};
+
+  /**
+   * @brief The exact address of the first touch.
+   */
+  address_t address{};
+
+  /**
+   * @brief The instruction pointer of the first toucher.
+   */
+  address_t ip{};
+
+  /**
+   * @brief The identifier of the thread that touched the page first.
+   */
+  std::uint32_t tid{};
+
+  /**
+   * @brief `steady_clock` timestamp of the first touch in nanoseconds.
+   */
+  std::uint64_t timestamp{};
+};
+
+/**
+ * @class access_sampler
+ * @brief Samples first-touch accesses to pages of the memory region.
+ *
+ * @details
+ * Revokes access (@ref protect::memory_prot::kNoAccess) of every `stride`-th
+ * page of the range. The first access to such page is caught by the SIGSEGV
+ * handler, recorded with timestamp and instruction pointer, and the original
+ * protection of the page is restored, so the following accesses cost nothing.
+ * @ref access_sampler::heat_map() shows which pages were actually used. The
+ * destructor restores original protection of every page that wasn't touched.
+ * Pages which are already inaccessible (or whose protection is unknown) aren't
+ * sampled and are never reported as touched.
+ *
+ * @code{.cpp}
+ * mywr::watch::access_sampler sampler{table, table_size, 4};
+ *
+ * run_workload();
+ *
+ * for (auto& page : sampler.heat_map())
+ *   if (!page.touched)
+ *     printf("%p is cold\n", (void*)page.page);
+ * @endcode
+ */
+class access_sampler {
+public:
+  /**
+   * @name Constructors & Destructor.
+   * @{
+   */
+
+  /**
+   * @brief Default constructor forbidden.
+   */
+  access_sampler() = delete;
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  access_sampler(const access_sampler&) = delete;
+
+  /**
+   * @brief Move constructor forbidden.
+   */
+  access_sampler(access_sampler&&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const access_sampler&) = delete;
+
+  /**
+   * @brief Move operator forbidden.
+   */
+  void operator=(access_sampler&&) = delete;
+
+  /**
+   * @brief Main constructor. Revokes access of sampled pages.
+   *
+   * @param[in] target The begin of the memory region to sample.
+   * @param[in] size   The size of the memory region to sample.
+   * @param[in] stride Every `stride`-th page of the region is sampled.
+   */
+  access_sampler(const address&    target,
+                 const std::size_t size,
+                 const std::size_t stride = 1) {
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+    address_range area  = address_range::from_size(target, size).page_aligned();
+    address_t     begin = area.begin();
+    address_t     end   = area.end();
+
+    m_begin     = begin;
+    m_page_size = static_cast<address_t>(page_size());
+    m_stride    = stride ? stride : 1;
+    m_count     = (area.page_count() + m_stride - 1) / m_stride;
+    m_pages     = std::make_unique<sampled_page[]>(m_count);
+
+    /**
+     * Remember the original protection of each page before any page faults,
+     * registering the range publishes it to the signal handler. Pages which
+     * are already inaccessible would never get access back, skip them.
+     */
+    for (std::size_t i = 0; i < m_count; ++i) {
+      sampled_page& page = m_pages[i];
+
+      page.access.page = begin + i * m_stride * m_page_size;
+      page.original    = protect::get_protect(page.access.page);
+      if (page.original == protect::memory_prot::kNoAccess)
+        page.original = protect::memory_prot::kUnknown;
+    }
+
+    m_slot = impl::register_fault_range(
+        begin, end, &access_sampler::on_fault, this);
+    if (!m_slot)
+      return;
+
+    /**
+     * Revoke access of sampled pages.
+     */
+    for (std::size_t i = 0; i < m_count; ++i) {
+      sampled_page& page = m_pages[i];
+      if (page.original == protect::memory_prot::kUnknown)
+        continue;
+
+      protect::set_protect(
+          page.access.page, m_page_size, protect::memory_prot::kNoAccess);
+    }
+#endif
+  }
+
+  /**
+   * @brief Destructor. Restores the original protection of untouched pages.
+   */
+  ~access_sampler() {
+    stop();
+  }
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Public Member Functions
+   * @{
+   */
+
+  /**
+   * @brief Returns `true` if sampling was started.
+   */
+  MYWR_INLINE bool good() const {
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+    return m_slot != nullptr;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Stops sampling and restores the original protection of untouched
+   * pages. Called by destructor.
+   */
+  void stop() {
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+    if (!m_slot)
+      return;
+
+    for (std::size_t i = 0; i < m_count; ++i)
+      restore(m_pages[i]);
+
+    impl::unregister_fault_range(m_slot);
+    m_slot = nullptr;
+#endif
+  }
+
+  /**
+   * @brief Returns the state of every sampled page ordered by address.
+   */
+  std::vector<page_access> heat_map() const {
+    std::vector<page_access> pages;
+    pages.reserve(m_count);
+
+    for (std::size_t i = 0; i < m_count; ++i) {
+      page_access access = m_pages[i].access;
+      access.touched = m_pages[i].touched.load(std::memory_order_acquire);
+      pages.push_back(access);
+    }
+    return pages;
+  }
+
+  /**
+   * @brief Returns the number of sampled pages that were touched.
+   */
+  std::size_t touched() const {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_count; ++i)
+      count += m_pages[i].touched.load(std::memory_order_acquire);
+    return count;
+  }
+
+  /**
+   * @}
+   */
+
+private:
+  /**
+   * @brief State of the sampled page.
+   */
+  struct sampled_page {
+    page_access                access{};
+    std::atomic<bool>          claimed{};
+    std::atomic<bool>          touched{};
+    std::atomic<bool>          restored{};
+    protect::memory_prot::Enum original{};
+  };
+
+#if defined(MYWR_LINUX) && !defined(MYWR_FEATURE_NO_MPROTECT)
+  /**
+   * @brief Restores the original protection of the page once.
+   */
+  bool restore(sampled_page& page) {
+    if (page.original == protect::memory_prot::kUnknown ||
+        page.restored.exchange(true, std::memory_order_acq_rel))
+      return true;
+
+    return mprotect(reinterpret_cast<void*>(page.access.page),
+                    m_page_size,
+                    protect::from_protection_constant(page.original)) == 0;
+  }
+
+  /**
+   * @brief Fault callback. Runs inside the signal handler.
+   */
+  static bool on_fault(void* context, address_t address, address_t ip) {
+    auto*       self  = static_cast<access_sampler*>(context);
+    std::size_t index = (address - self->m_begin) / self->m_page_size;
+
+    if (index % self->m_stride != 0)
+      return false;
+
+    sampled_page& page = self->m_pages[index / self->m_stride];
+    if (page.original == protect::memory_prot::kUnknown)
+      return false;
+
+    if (!page.claimed.exchange(true, std::memory_order_acq_rel)) {
+      page.access.address   = address;
+      page.access.ip        = ip;
+      page.access.tid       = static_cast<std::uint32_t>(syscall(SYS_gettid));
+      page.access.timestamp = static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch())
+              .count());
+      page.touched.store(true, std::memory_order_release);
+    }
+
+    return self->restore(page);
+  }
+
+  /**
+   * @name Private Member variables
+   * @{
+   */
+
+  /**
+   * @brief Slot in the fault dispatch table.
+   */
+  impl::fault_slot* m_slot{};
+#endif
+
+  /**
+   * @brief The begin of the sampled range aligned to the page.
+   */
+  address_t m_begin{};
+
+  /**
+   * @brief The size of the page.
+   */
+  address_t m_page_size{};
+
+  /**
+   * @brief Every `m_stride`-th page is sampled.
+   */
+  std::size_t m_stride{1};
+
+  /**
+   * @brief The number of sampled pages.
+   */
+  std::size_t m_count{};
+
+  /**
+   * @brief Sampled pages.
+   */
+  std::unique_ptr<sampled_page[]> m_pages{};
+
+  /**
+   * @}
+   */
+};
+} // namespace watch
+} // namespace mywr
+
+#endif // !MYWR_WATCH_HPP_
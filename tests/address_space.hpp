@@ -0,0 +1,255 @@
+/*********************************************************************
+ * @file   address_space.hpp
+ * @brief  Large address spaces for scaling tests and benchmarks.
+ *
+ * @details
+ * Production processes have tens of thousands of mappings, the test binary
+ * only a few dozens. @ref synthetic_address_space maps that many distinct
+ * regions in the process itself, @ref scale_maps builds maps text of any
+ * size out of recorded maps files from `tests/data/maps`. Shared by the
+ * tests and the benchmarks, so it doesn't depend on gtest.
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_TESTS_ADDRESS_SPACE_HPP_
+#define MYWR_TESTS_ADDRESS_SPACE_HPP_
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mywr/mywr.hpp"
+
+#if defined(MYWR_LINUX)
+  #include <sys/prctl.h>
+#endif
+
+#if !defined(MYWR_TEST_DATA_DIR)
+  #define MYWR_TEST_DATA_DIR "tests/data"
+#endif
+
+namespace mywr_test {
+/**
+ * @brief Returns the contents of the recorded maps file
+ * `tests/data/maps/<name>` or an empty string if it can't be read.
+ */
+inline std::string load_maps(std::string_view name) {
+  std::ifstream file(std::string{MYWR_TEST_DATA_DIR "/maps/"}.append(name),
+                     std::ios::binary);
+
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+/**
+ * @brief Builds maps text of `regions` lines by repeating the lines of the
+ * recorded maps. Addresses are rewritten to ascending, non-overlapping ranges
+ * of the recorded sizes, everything after them is kept as recorded.
+ */
+inline std::string scale_maps(std::string_view recorded, std::size_t regions) {
+  std::vector<std::pair<std::size_t, std::string_view>> lines;
+  for (std::size_t begin = 0; begin < recorded.size();) {
+    std::size_t end = recorded.find('\n', begin);
+    if (end == std::string_view::npos)
+      end = recorded.size();
+
+    std::string_view line  = recorded.substr(begin, end - begin);
+    std::size_t      dash  = line.find('-');
+    std::size_t      space = line.find(' ');
+    begin                  = end + 1;
+    if (dash == std::string_view::npos || space == std::string_view::npos)
+      continue;
+
+    unsigned long long first = 0, last = 0;
+    std::from_chars(line.data(), line.data() + dash, first, 16);
+    std::from_chars(line.data() + dash + 1, line.data() + space, last, 16);
+    lines.push_back({static_cast<std::size_t>(last - first),
+                     line.substr(space)});
+  }
+
+  std::string text;
+  if (lines.empty())
+    return text;
+
+  text.reserve(regions * 96);
+
+  char               range[40];
+  unsigned long long address = 0x10000;
+  for (std::size_t i = 0; i < regions; i++) {
+    const auto& [size, rest] = lines[i % lines.size()];
+    std::snprintf(range, sizeof(range), "%llx-%llx", address, address + size);
+    text.append(range).append(rest).append("\n");
+
+    // Leave a page between ranges, so no two lines are contiguous.
+    address += size + 0x1000;
+  }
+  return text;
+}
+
+#if defined(MYWR_LINUX)
+/**
+ * @class synthetic_address_space
+ * @brief Adds distinct mappings to the process.
+ *
+ * @details
+ * Maps one anonymous area and splits it into one-page regions: odd pages are
+ * read-only, even ones read-write, and with @ref named every region gets its
+ * own name by `prctl(PR_SET_VMA_ANON_NAME)` (Linux 5.17+ with
+ * `CONFIG_ANON_VMA_NAME`), shown as `[anon:mywr-<index>]`. The number of
+ * regions is limited by `vm.max_map_count`.
+ */
+class synthetic_address_space {
+public:
+  /**
+   * @brief Main constructor.
+   *
+   * @param[in] regions The number of regions to add.
+   * @param[in] names   Name the regions if the kernel supports it.
+   */
+  explicit synthetic_address_space(std::size_t regions, bool names = true)
+      : m_regions(regions)
+      , m_size(regions * mywr::page_size()) {
+    if (regions == 0)
+      return;
+
+    void* data = mmap(nullptr,
+                      m_size,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                      -1,
+                      0);
+    if (data == MAP_FAILED)
+      return;
+    m_data = static_cast<mywr::byte_t*>(data);
+
+    std::size_t page = mywr::page_size();
+    for (std::size_t i = 1; i < regions; i += 2) {
+      if (mprotect(m_data + i * page, page, PROT_READ) != 0) {
+        release();
+        return;
+      }
+    }
+
+    m_named = names && name_regions();
+  }
+
+  ~synthetic_address_space() {
+    release();
+  }
+
+  /**
+   * @brief Copy constructor forbidden.
+   */
+  synthetic_address_space(const synthetic_address_space&) = delete;
+
+  /**
+   * @brief Copy operator forbidden.
+   */
+  void operator=(const synthetic_address_space&) = delete;
+
+  /**
+   * @brief Returns `false` if the regions couldn't be created, usually
+   * because of `vm.max_map_count`.
+   */
+  bool good() const {
+    return m_regions == 0 || m_data != nullptr;
+  }
+
+  /**
+   * @brief Returns `true` if the regions were named.
+   */
+  bool named() const {
+    return m_named;
+  }
+
+  /**
+   * @brief Returns the number of regions.
+   */
+  std::size_t regions() const {
+    return m_regions;
+  }
+
+  /**
+   * @brief Returns the begin of the region.
+   */
+  mywr::byte_t* region(std::size_t index) const {
+    return m_data + index * mywr::page_size();
+  }
+
+  /**
+   * @brief Returns the protection of the region.
+   */
+  static mywr::protect::memory_prot::Enum protection(std::size_t index) {
+    return index % 2 ? mywr::protect::memory_prot::kRead
+                     : mywr::protect::memory_prot::kReadWrite;
+  }
+
+  /**
+   * @brief Returns the name of the region as shown in the maps file.
+   */
+  static std::string name(std::size_t index) {
+    return "[anon:mywr-" + std::to_string(index) + "]";
+  }
+
+private:
+  /**
+   * @brief Names every region, stops at the first failure.
+   */
+  bool name_regions() {
+  #if defined(PR_SET_VMA)
+    for (std::size_t i = 0; i < m_regions; i++) {
+      std::string label = "mywr-" + std::to_string(i);
+      if (prctl(PR_SET_VMA,
+                PR_SET_VMA_ANON_NAME,
+                reinterpret_cast<unsigned long>(region(i)),
+                mywr::page_size(),
+                reinterpret_cast<unsigned long>(label.c_str())) != 0)
+        return false;
+    }
+    return true;
+  #else
+    return false;
+  #endif
+  }
+
+  void release() {
+    if (m_data)
+      munmap(m_data, m_size);
+    m_data = nullptr;
+  }
+
+  std::size_t   m_regions{};
+  std::size_t   m_size{};
+  mywr::byte_t* m_data{};
+  bool          m_named{};
+};
+
+/**
+ * @brief Returns the number of mappings the process may still create.
+ */
+inline std::size_t available_mappings() {
+  std::size_t limit = 65530;
+
+  std::ifstream max_map_count("/proc/sys/vm/max_map_count");
+  max_map_count >> limit;
+
+  std::size_t used = 0;
+  mywr::procfs::for_each_region([&used](const mywr::procfs::memory_region&) {
+    ++used;
+  });
+
+  // Keep some for the allocator and the test itself.
+  return limit > used + 1024 ? limit - used - 1024 : 0;
+}
+#endif
+} // namespace mywr_test
+
+#endif // !MYWR_TESTS_ADDRESS_SPACE_HPP_
@@ -59,6 +59,19 @@ TEST(AddressTest, ShouldLogicOperate) {
   ASSERT_TRUE(address != mywr::address{124});
 }
 
+TEST(AddressTest, ShouldOperateAtCompileTime) {
+  constexpr mywr::address base{0x400000};
+  constexpr mywr::address offset{0x1234};
+  constexpr mywr::address sum = base + offset;
+
+  static_assert(sum.value() == 0x401234);
+  static_assert((sum - offset) == base);
+  static_assert(sum != base);
+  static_assert(mywr::address{}.value() == 0);
+
+  ASSERT_EQ(sum.value(), 0x401234);
+}
+
 TEST(AddressTest, ShouldAssignOperate) {
   auto address = mywr::address{123};
 
@@ -72,3 +85,48 @@ TEST(AddressTest, ShouldAssignOperate) {
 
   ASSERT_EQ(address.value(), 125);
 }
+
+TEST(AddressRangeTest, ShouldOperateOnRanges) {
+  constexpr mywr::address_range range{0x1000, 0x3000};
+  constexpr mywr::address_range other{0x2000, 0x4000};
+
+  static_assert(range.size() == 0x2000);
+  static_assert(range.contains(0x1000) && !range.contains(0x3000));
+  static_assert(range.overlaps(other));
+  static_assert(!range.overlaps(mywr::address_range{0x3000, 0x4000}));
+  static_assert(range.intersection(other) ==
+                mywr::address_range{0x2000, 0x3000});
+  static_assert(range.merge(other) == mywr::address_range{0x1000, 0x4000});
+
+  constexpr auto parts = range.subtract(mywr::address_range{0x1800, 0x2000});
+  static_assert(parts.first == mywr::address_range{0x1000, 0x1800});
+  static_assert(parts.second == mywr::address_range{0x2000, 0x3000});
+
+  constexpr auto rest = range.subtract(other);
+  static_assert(rest.first == mywr::address_range{0x1000, 0x2000});
+  static_assert(rest.second.empty());
+
+  ASSERT_TRUE(range.contains(range.intersection(other)));
+}
+
+TEST(AddressRangeTest, ShouldAlignToPages) {
+  const std::size_t page = mywr::page_size();
+  ASSERT_NE(page, 0u);
+
+  auto range = mywr::address_range::from_size(page * 3 + 1, page);
+  auto area  = range.page_aligned();
+  ASSERT_EQ(area.begin(), page * 3);
+  ASSERT_EQ(area.end(), page * 5);
+  ASSERT_EQ(range.page_count(), 2u);
+
+  std::vector<mywr::address_t> pages;
+  for (mywr::address_t begin : range.pages())
+    pages.push_back(begin);
+  ASSERT_EQ(pages, (std::vector<mywr::address_t>{page * 3, page * 4}));
+
+  if (std::size_t huge = mywr::huge_page_size()) {
+    auto huge_area = range.huge_page_aligned();
+    ASSERT_EQ(huge_area.begin() % huge, 0u);
+    ASSERT_TRUE(huge_area.contains(range));
+  }
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+
+using namespace mywr::arena;
+using mywr::protect::memory_prot;
+
+TEST(ArenaTest, MapsTwoViews) {
+  code_arena arena{100};
+  ASSERT_TRUE(arena.good());
+
+  EXPECT_GE(arena.capacity(), 100);
+  EXPECT_NE(arena.executable(), arena.writable());
+  EXPECT_EQ(mywr::protect::get_protect(arena.executable()),
+            memory_prot::kExecuteRead);
+  EXPECT_EQ(mywr::protect::get_protect(arena.writable()),
+            memory_prot::kReadWrite);
+}
+
+TEST(ArenaTest, AllocatesBlocks) {
+  code_arena arena{4096};
+  ASSERT_TRUE(arena.good());
+
+  auto first  = arena.allocate(3);
+  auto second = arena.allocate(5, 16);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+
+  EXPECT_EQ(second.executable.value() % 16, 0);
+  EXPECT_GE(second.executable.value(), first.executable.value() + 3);
+  EXPECT_EQ(arena.to_writable(second.executable), second.writable);
+  EXPECT_EQ(arena.to_executable(second.writable), second.executable);
+  EXPECT_TRUE(arena.contains(second.executable));
+  EXPECT_FALSE(arena.contains(second.writable));
+
+  EXPECT_FALSE(arena.allocate(arena.capacity()));
+}
+
+TEST(ArenaTest, ExecutesWrittenCode) {
+  // mov eax, imm32; ret
+  mywr::byte_t code[]{0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3};
+
+  code_arena arena{4096};
+  ASSERT_TRUE(arena.good());
+
+  auto stub = arena.allocate(sizeof(code));
+  ASSERT_TRUE(arena.write(stub.executable, code, sizeof(code)));
+  EXPECT_EQ(reinterpret_cast<int (*)()>(stub.executable.value())(), 42);
+
+  // Re-patch the immediate without touching protection.
+  code[1] = 0x18;
+  ASSERT_TRUE(arena.write(stub.executable, code, sizeof(code)));
+  EXPECT_EQ(reinterpret_cast<int (*)()>(stub.executable.value())(), 24);
+  EXPECT_EQ(mywr::protect::get_protect(stub.executable),
+            memory_prot::kExecuteRead);
+
+  EXPECT_FALSE(arena.write(stub.writable, code, sizeof(code)));
+}
@@ -29,3 +29,31 @@ TEST(DisassemblerTest, ProducesBasicDisassembling) {
     offset += insn.len;
   }
 }
+
+TEST(DisassemblerTest, DisassemblesRanges) {
+  const mywr::byte_t code[]{
+      0xFF,
+      0xE0, // jmp eax
+      0x5B, // pop ebx
+      0x5D, // pop ebp,
+      0xC3, // retn
+  };
+
+  std::vector<mywr::byte_t> opcodes;
+  auto collect = [&opcodes](mywr::address, const instruction& insn) {
+    opcodes.push_back(insn.opcode);
+  };
+
+  EXPECT_EQ(disassemble(code, sizeof(code), collect), sizeof(code));
+  EXPECT_EQ(opcodes, (std::vector<mywr::byte_t>{0xFF, 0x5B, 0x5D, 0xC3}));
+
+  // The callback stops the walk after `pop ebp`.
+  std::size_t size = disassemble(
+      code, sizeof(code), [](mywr::address, const instruction& insn) {
+        return insn.opcode != 0x5D;
+      });
+  EXPECT_EQ(size, 4);
+
+  // The instruction crossing the end isn't disassembled.
+  EXPECT_EQ(disassemble(code, 1, collect), 0);
+}
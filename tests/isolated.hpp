@@ -0,0 +1,51 @@
+/*********************************************************************
+ * @file   isolated.hpp
+ * @brief  Runs statements in a child process.
+ *
+ * @details
+ * A joined thread still leaves its cached stack with a `PROT_NONE` guard
+ * page and, once it allocated, a reserved malloc arena in the address
+ * space. Tests which spawn threads run them in a forked child, so the
+ * tests parsing `/proc/self/maps` afterwards see the same mappings as
+ * before. Failed expectations of the child make it exit with a non-zero
+ * code and are printed with its output.
+ *
+ * @code{.cpp}
+ * EXPECT_ISOLATED({
+ *   std::thread worker{[] { ... }};
+ *   worker.join();
+ *   EXPECT_EQ(value, 1);
+ * });
+ * @endcode
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_TESTS_ISOLATED_HPP_
+#define MYWR_TESTS_ISOLATED_HPP_
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+namespace mywr_test {
+/**
+ * @brief Runs the function and exits with its test result.
+ */
+template <typename Fn>
+[[noreturn]] void exit_with_result(Fn&& fn) {
+  fn();
+  std::exit(::testing::Test::HasFailure() ? 1 : 0);
+}
+} // namespace mywr_test
+
+/**
+ * @brief Expects the statements to pass in a forked child process.
+ */
+#define EXPECT_ISOLATED(...)                                                   \
+  EXPECT_EXIT(::mywr_test::exit_with_result([&] { __VA_ARGS__; }),             \
+              ::testing::ExitedWithCode(0),                                    \
+              "")
+
+#endif // !MYWR_TESTS_ISOLATED_HPP_
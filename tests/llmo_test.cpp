@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#if defined(__linux__)
+  #include <sys/wait.h>
+#endif
+
 #include "mywr/mywr.hpp"
+#include "isolated.hpp"
+#include "syscall_budget.hpp"
 
 namespace llmo = mywr::llmo;
 
@@ -9,9 +15,9 @@ TEST(LLMOTest, ShouldProcessDefaultLLMOperations) {
   int copyValue = 90;
   int cmpValue  = 24;
 
-  ASSERT_EQ(llmo::read<int>(&value), 2);
+  EXPECT_SYSCALLS_LE(4, ASSERT_EQ(llmo::read<int>(&value), 2));
 
-  llmo::write<int>(&value, 123);
+  EXPECT_SYSCALLS_LE(4, llmo::write<int>(&value, 123));
 
   ASSERT_EQ(value, 123);
 
@@ -27,3 +33,394 @@ TEST(LLMOTest, ShouldProcessDefaultLLMOperations) {
   // 0xc0000005 if one of args is not an object (except size).
   ASSERT_EQ(llmo::compare(&value, &cmpValue, 1), 0);
 }
+
+TEST(LLMOTest, ShouldProcessBulkOperations) {
+  struct record {
+    int    id;
+    double values[8];
+  };
+
+  record source{7, {1, 2, 3, 4, 5, 6, 7, 8}};
+  record copy{};
+
+  llmo::read_into(&source, copy);
+  ASSERT_EQ(copy.id, 7);
+  ASSERT_EQ(copy.values[7], 8);
+
+  std::vector<int> array(10000);
+  for (std::size_t i = 0; i < array.size(); i++)
+    array[i] = static_cast<int>(i);
+
+  auto read = llmo::read_span<int>(array.data(), array.size());
+  ASSERT_EQ(read, array);
+
+  std::vector<int> reversed(array.rbegin(), array.rend());
+  llmo::write_span(array.data(), reversed.data(), reversed.size());
+  ASSERT_EQ(array, reversed);
+}
+
+namespace {
+struct leaf {
+  std::uint64_t pad;
+  int           value;
+};
+
+struct middle {
+  char  pad[0x48];
+  leaf* next;
+};
+
+struct root {
+  char    pad[0x10];
+  middle* next;
+};
+
+constexpr std::ptrdiff_t kRootOffset   = offsetof(root, next);
+constexpr std::ptrdiff_t kMiddleOffset = offsetof(middle, next);
+constexpr std::ptrdiff_t kLeafOffset   = offsetof(leaf, value);
+} // namespace
+
+TEST(LLMOTest, ShouldResolvePointerChains) {
+  leaf   first{0, 42};
+  middle second{{}, &first};
+  root   third{{}, &second};
+
+  auto resolved =
+      llmo::resolve_chain(&third, {kRootOffset, kMiddleOffset, kLeafOffset});
+  ASSERT_EQ(resolved.value(), mywr::address{&first.value}.value());
+  ASSERT_EQ((llmo::resolve_chain<kRootOffset, kMiddleOffset, kLeafOffset>(
+                 &third)
+                 .value()),
+            resolved.value());
+
+  int value{};
+  ASSERT_TRUE(llmo::try_read(resolved, value));
+  ASSERT_EQ(value, 42);
+
+  // Broken chains resolve to zero instead of faulting.
+  second.next = nullptr;
+  ASSERT_EQ(
+      llmo::resolve_chain(&third, {kRootOffset, kMiddleOffset, kLeafOffset})
+          .value(),
+      0);
+  ASSERT_FALSE(llmo::try_read(0x10, value));
+}
+
+#if defined(MYWR_LINUX)
+TEST(LLMOTest, ShouldResolveOwnChainsAfterFork) {
+  // Open the descriptors in the parent.
+  int value{};
+  ASSERT_TRUE(llmo::try_read(&value, value));
+  ASSERT_GE(llmo::impl::mem_descriptor(), 0);
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    // Exercise the /proc/self/mem fallback too.
+    for (bool fallback : {false, true}) {
+      llmo::impl::g_no_vm_readv.store(fallback);
+
+      // The chain lives in a mapping the parent doesn't have.
+      auto* page = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                                   mywr::page_size(),
+                                                   PROT_READ | PROT_WRITE,
+                                                   MAP_PRIVATE | MAP_ANONYMOUS,
+                                                   -1,
+                                                   0));
+      if (page == MAP_FAILED)
+        _exit(1);
+
+      auto* first  = new (page + 0x200) leaf{0, 7};
+      auto* second = new (page + 0x100) middle{{}, first};
+      auto* third  = new (page) root{{}, second};
+
+      auto resolved = llmo::resolve_chain(
+          third, {kRootOffset, kMiddleOffset, kLeafOffset});
+      if (resolved.value() != mywr::address{&first->value}.value())
+        _exit(2);
+
+      int read{};
+      if (!llmo::try_read(resolved, read) || read != 7)
+        _exit(3);
+
+      // The second read revalidates the links by `read_slots`.
+      llmo::pointer_chain chain{third,
+                                {kRootOffset, kMiddleOffset, kLeafOffset}};
+      first->value = 8;
+      if (!chain.read(read) || !chain.read(read) || read != 8)
+        _exit(4);
+    }
+    _exit(0);
+  }
+
+  int result = 0;
+  ASSERT_EQ(waitpid(child, &result, 0), child);
+  ASSERT_TRUE(WIFEXITED(result));
+  EXPECT_EQ(WEXITSTATUS(result), 0);
+}
+#endif
+
+TEST(LLMOTest, ShouldCachePointerChains) {
+  leaf   first{0, 42};
+  leaf   other{0, 24};
+  middle second{{}, &first};
+  root   third{{}, &second};
+
+  llmo::pointer_chain chain{&third, {kRootOffset, kMiddleOffset, kLeafOffset}};
+
+  int value{};
+  ASSERT_TRUE(chain.read(value));
+  ASSERT_EQ(value, 42);
+
+  first.value = 43;
+  ASSERT_TRUE(chain.read(value));
+  ASSERT_EQ(value, 43);
+
+  // Changed link is noticed by the revalidation.
+  second.next = &other;
+  ASSERT_EQ(chain.resolve().value(), mywr::address{&other.value}.value());
+
+  second.next = nullptr;
+  ASSERT_FALSE(chain.read(value));
+
+  second.next = &first;
+  ASSERT_TRUE(chain.read(value));
+  ASSERT_EQ(value, 43);
+}
+
+template<std::size_t N>
+static void expect_fixed_copies() {
+  std::array<mywr::byte_t, N> bytes{};
+  for (std::size_t i = 0; i < N; i++)
+    bytes[i] = static_cast<mywr::byte_t>(0xA0 + i);
+
+  for (std::size_t offset = 0; offset < 32; offset++) {
+    alignas(64) mywr::byte_t buffer[64];
+    std::memset(buffer, 0xEE, sizeof(buffer));
+
+    llmo::write_bytes<N>(&buffer[offset], bytes);
+    for (std::size_t i = 0; i < sizeof(buffer); i++) {
+      bool inside = i >= offset && i < offset + N;
+      ASSERT_EQ(buffer[i], inside ? bytes[i - offset] : 0xEE) << N;
+    }
+  }
+}
+
+TEST(LLMOTest, ShouldCopyFixedSizes) {
+  expect_fixed_copies<1>();
+  expect_fixed_copies<2>();
+  expect_fixed_copies<3>();
+  expect_fixed_copies<4>();
+  expect_fixed_copies<5>();
+  expect_fixed_copies<8>();
+  expect_fixed_copies<14>();
+  expect_fixed_copies<16>();
+  expect_fixed_copies<24>();
+}
+
+TEST(LLMOTest, ShouldKeepConcurrentWritesOfNeighbours) {
+  EXPECT_ISOLATED({
+    struct alignas(8) word {
+      mywr::byte_t               patch[4];
+      std::atomic<std::uint32_t> counter;
+    } data{};
+
+    // Patches of data must not write back the bytes of the same word.
+    std::atomic<bool> done{false};
+    std::uint32_t     expected = 0;
+    std::thread       writer{[&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        data.counter.fetch_add(1, std::memory_order_relaxed);
+        expected++;
+      }
+    }};
+
+    {
+      // Held by the outer scope, the patches don't change protections.
+      mywr::protect::scoped_protect hold{
+          &data, sizeof(data), mywr::protect::memory_prot::kReadWrite};
+      for (int i = 0; i < 200000; i++)
+        llmo::write_bytes<3>(data.patch, {0x90, 0x90, 0x90});
+    }
+
+    done.store(true);
+    writer.join();
+    EXPECT_EQ(data.counter.load(), expected);
+  });
+}
+
+TEST(LLMOTest, ShouldCacheViews) {
+  leaf   first{0, 42};
+  middle second{{}, &first};
+  root   third{{}, &second};
+
+  llmo::view<int> direct{&first.value};
+  ASSERT_TRUE(direct.valid());
+
+  // Resolved views are plain loads.
+  EXPECT_NO_SYSCALLS(ASSERT_EQ(direct.load(), 42));
+
+  direct.store(43);
+  ASSERT_EQ(first.value, 43);
+  ASSERT_EQ(direct.load(std::memory_order_acquire), 43);
+
+  // The chain is resolved once, later changes of links are not noticed.
+  llmo::view<int> chained{&third, {kRootOffset, kMiddleOffset, kLeafOffset}};
+  ASSERT_EQ(chained.get(), &first.value);
+
+  leaf other{0, 24};
+  second.next = &other;
+  ASSERT_EQ(chained.load(), 43);
+
+  chained.reset();
+  ASSERT_EQ(chained.load(), 24);
+
+  // Field of the object behind the pointer.
+  llmo::field<int, kLeafOffset> field{&second, {kMiddleOffset, 0}};
+  ASSERT_EQ(field.get(), &other.value);
+
+  // Unresolvable views are retried.
+  static leaf* found = nullptr;
+  llmo::view<int> lazy{[](const void*) -> mywr::address_t {
+    return reinterpret_cast<mywr::address_t>(found);
+  }};
+  ASSERT_FALSE(lazy.valid());
+
+  int value{};
+  ASSERT_FALSE(lazy.try_load(value));
+  lazy.store(1);
+
+  found = &first;
+  ASSERT_TRUE(lazy.try_load(value));
+  ASSERT_EQ(value, 0);
+}
+
+#if defined(MYWR_LINUX)
+TEST(LLMOTest, ShouldResolveModuleViews) {
+  // The main executable contains the ELF magic at its begin.
+  llmo::view<std::uint32_t> magic{"", 0};
+  ASSERT_TRUE(magic.valid());
+  ASSERT_EQ(magic.load(), 0x464C457Fu);
+
+  // Writes unprotect read-only memory.
+  llmo::view<mywr::byte_t> header{"", 7};
+  mywr::byte_t             abi = header.load();
+  header.store(0xCC);
+  ASSERT_EQ(header.load(), 0xCC);
+  header.store(abi);
+
+  llmo::view<int> missing{"missing.so", 0};
+  ASSERT_FALSE(missing.valid());
+}
+#endif
+
+TEST(LLMOTest, ShouldStreamFillAndCopy) {
+  std::vector<mywr::byte_t> source(4096 + 77);
+  for (std::size_t i = 0; i < source.size(); i++)
+    source[i] = static_cast<mywr::byte_t>(i * 7);
+
+  // Odd sizes and misaligned offsets pass heads, bodies and tails.
+  for (std::size_t offset : {0, 1, 13, 31}) {
+    for (std::size_t size : {0, 5, 64, 200, 4001}) {
+      std::vector<mywr::byte_t> buffer(source.size() + 64, 0xEE);
+
+      llmo::stream_fill(&buffer[offset], 0xA5, size, 0);
+      for (std::size_t i = 0; i < buffer.size(); i++) {
+        bool inside = i >= offset && i < offset + size;
+        ASSERT_EQ(buffer[i], inside ? 0xA5 : 0xEE);
+      }
+
+      llmo::stream_copy(&buffer[offset], &source[3], size, 0);
+      ASSERT_EQ(std::memcmp(&buffer[offset], &source[3], size), 0);
+      ASSERT_EQ(buffer[offset + size], 0xEE);
+    }
+  }
+}
+
+#if defined(MYWR_LINUX)
+TEST(LLMOTest, ShouldForceWrite) {
+  std::size_t size = mywr::page_size();
+  auto*       page = static_cast<int*>(
+      mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ASSERT_NE(page, MAP_FAILED);
+
+  // One write to `/proc/self/mem`, no protection changes.
+  EXPECT_SYSCALLS_LE(1, ASSERT_TRUE(llmo::force_write<int>(page, 123)));
+  EXPECT_EQ(*page, 123);
+  EXPECT_EQ(mywr::protect::get_protect(page),
+            mywr::protect::memory_prot::kRead);
+
+  munmap(page, size);
+}
+
+TEST(LLMOTest, ShouldForceWriteOwnProcessAfterFork) {
+  static volatile int value = 1;
+
+  // Open the descriptor in the parent.
+  ASSERT_TRUE(llmo::force_write<int>(const_cast<int*>(&value), 2));
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    bool written = llmo::force_write<int>(const_cast<int*>(&value), 42);
+    _exit(written && value == 42 ? 0 : 1);
+  }
+
+  int result = 0;
+  ASSERT_EQ(waitpid(child, &result, 0), child);
+  ASSERT_TRUE(WIFEXITED(result));
+  EXPECT_EQ(WEXITSTATUS(result), 0);
+  EXPECT_EQ(value, 2);
+}
+
+TEST(LLMOTest, ShouldForceWriteBatch) {
+  std::size_t size = mywr::page_size();
+  auto*       code = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                               size,
+                                               PROT_READ | PROT_EXEC,
+                                               MAP_PRIVATE | MAP_ANONYMOUS,
+                                               -1,
+                                               0));
+  ASSERT_NE(code, MAP_FAILED);
+
+  // mov eax, 42; ret
+  mywr::byte_t  mov   = 0xB8;
+  std::uint32_t value = 42;
+  mywr::byte_t  ret   = 0xC3;
+  llmo::patch   patches[]{
+      {code,      &mov,   1            },
+      {code + 1,  &value, sizeof(value)},
+      {code + 5,  &ret,   1            },
+      {code + 64, &ret,   1            },
+  };
+
+  // Adjacent patches are merged, one write per run.
+  EXPECT_SYSCALLS_LE(
+      2, ASSERT_TRUE(llmo::force_write(patches, std::size(patches))));
+  EXPECT_EQ(reinterpret_cast<int (*)()>(code)(), 42);
+  EXPECT_EQ(code[64], 0xC3);
+  EXPECT_EQ(mywr::protect::get_protect(code),
+            mywr::protect::memory_prot::kExecuteRead);
+
+  munmap(code, size);
+}
+
+TEST(LLMOTest, ShouldWriteBytesToCode) {
+  std::size_t size = mywr::page_size();
+  auto*       code = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                               size,
+                                               PROT_READ | PROT_EXEC,
+                                               MAP_PRIVATE | MAP_ANONYMOUS,
+                                               -1,
+                                               0));
+  ASSERT_NE(code, MAP_FAILED);
+
+  // mov eax, 42; ret
+  llmo::write_bytes<6>(code + 2, {0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3});
+  EXPECT_EQ(reinterpret_cast<int (*)()>(code + 2)(), 42);
+  EXPECT_EQ(mywr::protect::get_protect(code),
+            mywr::protect::memory_prot::kExecuteRead);
+
+  munmap(code, size);
+}
+#endif
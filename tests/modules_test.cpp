@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+#include "syscall_budget.hpp"
+
+namespace modules = mywr::modules;
+
+#if defined(MYWR_LINUX)
+TEST(ModulesTest, ShouldFindMainExecutable) {
+  modules::flush_cache();
+
+  mywr::address_t base = modules::base("");
+  ASSERT_NE(base, 0u);
+
+  // ELF magic.
+  ASSERT_EQ(std::memcmp(reinterpret_cast<const void*>(base), "\x7F" "ELF", 4),
+            0);
+  ASSERT_EQ(modules::base("missing.so"), 0u);
+}
+
+TEST(ModulesTest, ShouldCacheBases) {
+  modules::flush_cache();
+  mywr::address_t base = modules::base("");
+
+  EXPECT_NO_SYSCALLS(ASSERT_EQ(modules::base(""), base));
+}
+
+TEST(ModulesTest, ShouldResolveTables) {
+  static mywr::module_address table[] = {
+      {"",           0x0 },
+      {"",           0x10},
+      {"missing.so", 0x20},
+  };
+
+  modules::flush_cache();
+  ASSERT_EQ(mywr::module_address::resolve_all(table, std::size(table)), 2u);
+
+  mywr::address_t base = modules::base("");
+  EXPECT_EQ(table[0].resolve().value(), base);
+  EXPECT_EQ(table[1].resolve().value(), base + 0x10);
+  EXPECT_FALSE(table[2].resolved());
+  EXPECT_EQ(table[2].resolve().value(), 0u);
+}
+#endif
+
+TEST(ModulesTest, ShouldConstructAtCompileTime) {
+  constexpr mywr::module_address entry{"game.so", 0x1234};
+
+  static_assert(entry.module() == "game.so");
+  static_assert(entry.rva() == 0x1234);
+  static_assert(!entry.resolved());
+}
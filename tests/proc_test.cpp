@@ -1,7 +1,13 @@
 #include <gtest/gtest.h>
 
+#if defined(__unix__)
+  #include <sys/wait.h>
+#endif
+
 #include "mywr/mywr.hpp"
 
+#include "address_space.hpp"
+
 #if defined(MYWR_UNIX)
 using namespace mywr::procfs;
 
@@ -39,6 +45,385 @@ TEST(ProcTest, HandlesPrivateShared) {
   }
 }
 
+TEST(ProcTest, ParsesInMemoryBuffer) {
+  constexpr std::string_view kText = "first 1\nsecond 0x10\nthird";
+
+  parser parser{kText.data(), kText.size()};
+
+  int value{};
+  parser.scope();
+  parser.next_until_space();
+  EXPECT_EQ(parser.grab_view(), "first");
+  parser.next();
+  parser.scope();
+  parser.next_to_eol();
+  parser.grab_number(value);
+  EXPECT_EQ(value, 1);
+
+  parser.next_line();
+  EXPECT_EQ(parser.line(), "second 0x10");
+  std::size_t second = parser.offset();
+
+  parser.next_line();
+  EXPECT_EQ(parser.line(), "third");
+  EXPECT_FALSE(parser.eof());
+
+  parser.next_line();
+  EXPECT_TRUE(parser.eof());
+
+  parser.seek(second);
+  EXPECT_EQ(parser.line(), "second 0x10");
+}
+
+TEST(ProcTest, RereadsPersistentSource) {
+  source maps{"/proc/self/maps", 16};
+  ASSERT_TRUE(maps.good());
+
+  // Buffer grows to fit the whole file.
+  std::string_view first = maps.read();
+  ASSERT_FALSE(first.empty());
+  EXPECT_EQ(first.back(), '\n');
+
+  std::vector<memory_region> parsed;
+  parse_maps(maps, parsed);
+  EXPECT_FALSE(parsed.empty());
+
+  source missing{"/proc/self/does-not-exist"};
+  EXPECT_FALSE(missing.good());
+  EXPECT_TRUE(missing.read().empty());
+
+  parser parser{missing};
+  EXPECT_TRUE(parser.fail());
+  EXPECT_TRUE(parser.eof());
+}
+
+TEST(ProcTest, ParsesMapsText) {
+  constexpr std::string_view kMaps =
+      "00400000-00452000 r-xp 00000000 08:02 173521 /usr/bin/dbus-daemon\n"
+      "7ffd8b1e0000-7ffd8b201000 rw-p 00000000 00:00 0 [stack]\n"
+      "7f0000000000-7f0000001000 ---s 00001000 fd:01 42\n";
+
+  std::vector<memory_region> parsed;
+  parser                     parser{kMaps.data(), kMaps.size()};
+  parse_maps(parser, parsed);
+
+  ASSERT_EQ(parsed.size(), 3);
+  EXPECT_EQ(parsed[0].begin, 0x00400000);
+  EXPECT_EQ(parsed[0].end, 0x00452000);
+  EXPECT_EQ(parsed[0].permissions, PROT_READ | PROT_EXEC);
+  EXPECT_TRUE(parsed[0].is_private);
+  EXPECT_EQ(parsed[0].dev_minor, 2);
+  EXPECT_EQ(parsed[0].inode, 173521);
+  EXPECT_EQ(parsed[0].pathname, "/usr/bin/dbus-daemon");
+  EXPECT_EQ(parsed[1].pathname, "[stack]");
+  EXPECT_EQ(parsed[2].permissions, PROT_NONE);
+  EXPECT_TRUE(parsed[2].is_shared);
+  EXPECT_EQ(parsed[2].offset, 0x1000);
+  EXPECT_TRUE(parsed[2].pathname.empty());
+}
+
+TEST(ProcTest, ParsesSmapsText) {
+  constexpr std::string_view kSmaps =
+      "00400000-00452000 r-xp 00000000 08:02 173521 /usr/bin/dbus-daemon\n"
+      "Size:                328 kB\n"
+      "KernelPageSize:        4 kB\n"
+      "AnonHugePages:         0 kB\n"
+      "VmFlags: rd ex mr mw me\n"
+      "7f0000000000-7f0000400000 rw-p 00000000 00:00 0\n"
+      "Size:               4096 kB\n"
+      "KernelPageSize:        4 kB\n"
+      "AnonHugePages:      2048 kB\n"
+      "ShmemPmdMapped:        0 kB\n"
+      "FilePmdMapped:         0 kB\n"
+      "VmFlags: rd wr mr mw me ac hg\n";
+
+  smaps_region region{};
+  parser       first{kSmaps.data(), kSmaps.size()};
+  ASSERT_TRUE(parse_smaps(first, 0x00400010, region));
+  EXPECT_EQ(region.begin, 0x00400000);
+  EXPECT_EQ(region.end, 0x00452000);
+  EXPECT_EQ(region.kernel_page_size, 4096);
+  EXPECT_FALSE(region.transparent_huge());
+
+  parser second{kSmaps.data(), kSmaps.size()};
+  ASSERT_TRUE(parse_smaps(second, 0x7f0000200000, region));
+  EXPECT_EQ(region.anon_huge_pages, 2048 * 1024);
+  EXPECT_TRUE(region.transparent_huge());
+
+  parser missing{kSmaps.data(), kSmaps.size()};
+  EXPECT_FALSE(parse_smaps(missing, 0x1000, region));
+}
+
+TEST(ProcTest, QueriesRegion) {
+  int  local = 0;
+  auto heap  = std::make_unique<int>(0);
+
+  for (std::uintptr_t address : {reinterpret_cast<std::uintptr_t>(&local),
+                                 reinterpret_cast<std::uintptr_t>(heap.get()),
+                                 reinterpret_cast<std::uintptr_t>(&regions)}) {
+    memory_region queried{};
+    memory_region parsed{};
+
+    ASSERT_TRUE(query_region(address, queried, true));
+    ASSERT_TRUE(find_region(address, parsed));
+
+    EXPECT_EQ(queried.begin, parsed.begin);
+    EXPECT_EQ(queried.end, parsed.end);
+    EXPECT_EQ(queried.permissions, parsed.permissions);
+    EXPECT_EQ(queried.is_shared, parsed.is_shared);
+    EXPECT_EQ(queried.pathname, parsed.pathname);
+  }
+
+  memory_region region{};
+  EXPECT_FALSE(query_region(0, region));
+}
+
+TEST(ProcTest, IteratesRegions) {
+  std::size_t    count = 0;
+  std::uintptr_t last  = 0;
+
+  for_each_region([&](const memory_region& region) {
+    EXPECT_LT(region.begin, region.end);
+    EXPECT_GE(region.begin, last);
+    last = region.end;
+    ++count;
+  });
+  EXPECT_GT(count, 0);
+
+  // Iteration stops when callback returns false.
+  count = 0;
+  for_each_region([&](const memory_region&) {
+    return ++count < 2;
+  });
+  EXPECT_EQ(count, 2);
+}
+
+TEST(ProcTest, ReadsStatus) {
+  process_status status{};
+
+  ASSERT_TRUE(mywr::procfs::status(status));
+  EXPECT_GT(status.vm_rss, 0);
+  EXPECT_GE(status.vm_hwm, status.vm_rss);
+  EXPECT_GE(status.threads, 1);
+
+  // Second read goes through the remembered offsets.
+  process_status again{};
+  ASSERT_TRUE(mywr::procfs::status(again));
+  EXPECT_GE(again.voluntary_ctxt_switches, status.voluntary_ctxt_switches);
+}
+
+TEST(ProcTest, ReadsStat) {
+  process_stat stat{};
+
+  ASSERT_TRUE(mywr::procfs::stat(stat));
+  EXPECT_NE(stat.state, '\0');
+  EXPECT_GE(stat.num_threads, 1);
+  EXPECT_GT(stat.vsize, 0);
+  EXPECT_GT(stat.rss, 0);
+  EXPECT_GT(stat.minflt, 0);
+}
+
+TEST(ProcTest, ParsesStat) {
+  constexpr std::string_view kStat =
+      "4242 (a (b) c) S 1 4242 4242 0 -1 4194560 1500 0 3 0 25 7 0 0 20 0 4 "
+      "0 100 123456789 321 18446744073709551615\n";
+
+  process_stat stat{};
+  parser       full{kStat.data(), kStat.size()};
+  ASSERT_TRUE(parse_stat(full, stat));
+  EXPECT_EQ(stat.state, 'S');
+  EXPECT_EQ(stat.minflt, 1500);
+  EXPECT_EQ(stat.majflt, 3);
+  EXPECT_EQ(stat.utime, 25);
+  EXPECT_EQ(stat.stime, 7);
+  EXPECT_EQ(stat.num_threads, 4);
+  EXPECT_EQ(stat.vsize, 123456789);
+  EXPECT_EQ(stat.rss, 321);
+
+  // Truncated at every field must fail, not report zeroed fields.
+  for (std::string_view::size_type size :
+       {kStat.find(')') + 1, kStat.find(" S") + 2, kStat.find(" 1500")}) {
+    process_stat truncated{};
+    parser       text{kStat.data(), size};
+    EXPECT_FALSE(parse_stat(text, truncated)) << kStat.substr(0, size);
+  }
+
+  std::string_view rss_cut = kStat.substr(0, kStat.find(" 321") + 1);
+  process_stat     truncated{};
+  parser           text{rss_cut.data(), rss_cut.size()};
+  EXPECT_FALSE(parse_stat(text, truncated));
+
+  parser empty{"", 0};
+  EXPECT_FALSE(parse_stat(empty, truncated));
+}
+
+TEST(ProcTest, RereadsOwnProcessAfterFork) {
+  constexpr std::size_t kSize = 64 * 1024 * 1024;
+
+  // Open the cached sources in the parent.
+  process_status             before{};
+  std::vector<memory_region> parsed;
+  smaps_region               smaps{};
+  ASSERT_TRUE(status(before));
+  parse_maps(parsed);
+  ASSERT_TRUE(query_smaps(reinterpret_cast<std::uintptr_t>(&before), smaps));
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    process_status first{};
+    status(first);
+
+    void* data = mmap(nullptr,
+                      kSize,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                      -1,
+                      0);
+    if (data == MAP_FAILED)
+      _exit(1);
+
+    auto address = reinterpret_cast<std::uintptr_t>(data);
+
+    process_status second{};
+    if (!status(second) || second.vm_size < first.vm_size + kSize)
+      _exit(2);
+
+    parsed.clear();
+    parse_maps(parsed);
+    bool found = false;
+    for (const auto& region : parsed)
+      found |= address >= region.begin && address < region.end;
+    if (!found)
+      _exit(3);
+
+    if (!query_smaps(address, smaps))
+      _exit(4);
+    _exit(0);
+  }
+
+  int result = 0;
+  ASSERT_EQ(waitpid(child, &result, 0), child);
+  ASSERT_TRUE(WIFEXITED(result));
+  EXPECT_EQ(WEXITSTATUS(result), 0);
+}
+
+TEST(ProcTest, ParsesRecordedMaps) {
+  std::string maps = mywr_test::load_maps("server.maps");
+  ASSERT_FALSE(maps.empty());
+
+  std::vector<memory_region> parsed;
+  parser                     parser{maps.data(), maps.size()};
+  parse_maps(parser, parsed);
+
+  ASSERT_EQ(parsed.size(), 41);
+  EXPECT_EQ(parsed[0].begin, 0x55d4c6a00000);
+  EXPECT_EQ(parsed[0].dev_major, 0xfd);
+  EXPECT_EQ(parsed[0].dev_minor, 0x01);
+  EXPECT_EQ(parsed[0].inode, 2621510);
+  EXPECT_EQ(parsed[0].pathname, "/opt/server/bin/game_server");
+  EXPECT_EQ(parsed[1].permissions, PROT_READ | PROT_EXEC);
+  EXPECT_EQ(parsed[1].offset, 0x3e000);
+  EXPECT_TRUE(parsed[5].pathname.empty());
+  EXPECT_EQ(parsed[6].pathname, "[heap]");
+  EXPECT_EQ(parsed[8].permissions, PROT_NONE);
+  EXPECT_EQ(parsed[10].pathname, "[anon:worker stack]");
+  EXPECT_TRUE(parsed[11].is_shared);
+  EXPECT_EQ(parsed[11].pathname, "/dev/shm/server-state (deleted)");
+  EXPECT_EQ(parsed[40].begin, 0xffffffffff600000);
+  EXPECT_EQ(parsed[40].pathname, "[vsyscall]");
+
+  for (std::size_t i = 1; i < parsed.size(); i++)
+    EXPECT_GE(parsed[i].begin, parsed[i - 1].end);
+}
+
+TEST(ProcTest, ParsesEdgeCaseMaps) {
+  std::string maps = mywr_test::load_maps("edge_cases.maps");
+  ASSERT_FALSE(maps.empty());
+
+  std::vector<memory_region> parsed;
+  parser                     parser{maps.data(), maps.size()};
+  parse_maps(parser, parsed);
+
+  ASSERT_EQ(parsed.size(), 10);
+  EXPECT_EQ(parsed[0].pathname, "/opt/My Game/bin/game client");
+  EXPECT_EQ(parsed[0].dev_major, 0x08);
+  EXPECT_EQ(parsed[0].dev_minor, 0x02);
+
+  // No pathname in the middle of the file doesn't take the next line.
+  EXPECT_TRUE(parsed[3].pathname.empty());
+  EXPECT_EQ(parsed[3].inode, 42);
+  EXPECT_EQ(parsed[4].begin, 0x7f0000001000);
+  EXPECT_EQ(parsed[4].pathname, "/memfd:ring-buffer (deleted)");
+
+  EXPECT_EQ(parsed[5].pathname, "[anon:mywr-7]");
+  EXPECT_EQ(parsed[6].pathname, "[anon_shmem:ipc]");
+  EXPECT_EQ(parsed[7].pathname, "[stack:4242]");
+  EXPECT_EQ(parsed[8].offset, 0x7ffff000);
+  EXPECT_EQ(parsed[8].dev_major, 0x103);
+  EXPECT_EQ(parsed[8].inode, 9876543210ull);
+}
+
+TEST(ProcTest, ParsesScaledMaps) {
+  constexpr std::size_t kRegions = 50000;
+
+  std::string maps =
+      mywr_test::scale_maps(mywr_test::load_maps("server.maps"), kRegions);
+  ASSERT_FALSE(maps.empty());
+
+  std::vector<memory_region> parsed;
+  parser                     parser{maps.data(), maps.size()};
+  parse_maps(parser, parsed);
+
+  ASSERT_EQ(parsed.size(), kRegions);
+  for (std::size_t i = 1; i < parsed.size(); i++) {
+    ASSERT_LT(parsed[i - 1].end, parsed[i].begin);
+    ASSERT_EQ(parsed[i].pathname, parsed[i % 41].pathname);
+  }
+}
+
+  #if defined(MYWR_LINUX)
+TEST(ProcTest, ScalesToLargeAddressSpace) {
+  std::size_t regions = std::min<std::size_t>(
+      20000, mywr_test::available_mappings());
+  if (regions < 1000)
+    GTEST_SKIP() << "vm.max_map_count is too low";
+
+  std::vector<memory_region> before;
+  parse_maps(before);
+
+  mywr_test::synthetic_address_space space{regions};
+  ASSERT_TRUE(space.good());
+
+  std::vector<memory_region> after;
+  parse_maps(after);
+  EXPECT_GE(after.size(), before.size() + regions);
+
+  std::size_t found = 0;
+  for_each_region([&found](const memory_region&) {
+    ++found;
+  });
+  // `[vsyscall]` isn't a VMA, `PROCMAP_QUERY` doesn't report it.
+  EXPECT_GE(found + 1, after.size());
+
+  // Neighbours differ in protection, so every inner page is a region of its
+  // own even if the kernel can't name them.
+  for (std::size_t i = 1; i + 1 < regions; i += regions / 97) {
+    auto address = reinterpret_cast<std::uintptr_t>(space.region(i));
+    EXPECT_EQ(mywr::protect::get_protect(space.region(i)),
+              space.protection(i));
+
+    memory_region region{};
+    ASSERT_TRUE(query_region(address, region, true));
+    EXPECT_EQ(region.begin, address);
+    EXPECT_EQ(region.end, address + mywr::page_size());
+    if (space.named()) {
+      EXPECT_EQ(region.pathname, space.name(i));
+    }
+  }
+}
+  #endif
+
 /**
  * Offset, device minor, major, inode, pathname can be empty (or zero), so we don't test
  * them.
@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#if defined(__linux__)
+  #include <sys/wait.h>
+#endif
+
 #include "mywr/mywr.hpp"
+#include "isolated.hpp"
+#include "syscall_budget.hpp"
 
 namespace protect = mywr::protect;
 
@@ -40,6 +46,9 @@ TEST(ProtectTest, ShouldQueryProtection) {
   int value = 0;
 
   ASSERT_EQ(protect::get_protect(&value), memory_prot::kReadWrite);
+
+  // One query of the region, no maps parsing.
+  EXPECT_SYSCALLS_LE(1, protect::get_protect(&value));
 }
 
 TEST(ProtectTest, ShouldChangeProtection) {
@@ -50,9 +59,13 @@ TEST(ProtectTest, ShouldChangeProtection) {
                 &value, sizeof(value), memory_prot::kExecuteReadWrite),
             memory_prot::kReadWrite);
   ASSERT_EQ(protect::get_protect(&value), memory_prot::kExecuteReadWrite);
-  ASSERT_EQ(
-      protect::set_protect(&value, sizeof(value), memory_prot::kReadWrite),
-      memory_prot::kExecuteReadWrite);
+
+  // The query of the previous protection and `mprotect`.
+  memory_prot::Enum previous{};
+  EXPECT_SYSCALLS_LE(2,
+                     previous = protect::set_protect(
+                         &value, sizeof(value), memory_prot::kReadWrite));
+  ASSERT_EQ(previous, memory_prot::kExecuteReadWrite);
 }
 
 TEST(ProtectTest, ShouldUseRAII) {
@@ -69,3 +82,457 @@ TEST(ProtectTest, ShouldUseRAII) {
 
   ASSERT_EQ(protect::get_protect(&value), memory_prot::kReadWrite);
 }
+
+TEST(ProtectTest, ShouldShareNestedScopes) {
+  int   value   = 2;
+  auto& manager = protect::page_manager::instance();
+
+  {
+    protect::scoped_protect outer{
+        &value, sizeof(value), memory_prot::kExecuteReadWrite};
+    ASSERT_TRUE(outer.good());
+
+    // The page is already held, so the inner scope is free.
+    EXPECT_NO_SYSCALLS({
+      protect::scoped_protect inner{
+          &value, sizeof(value), memory_prot::kExecuteReadWrite};
+      ASSERT_TRUE(inner.good());
+      ASSERT_EQ(manager.references(&value), 2);
+    });
+
+    // The inner scope must not restore the page while the outer one holds it.
+    ASSERT_EQ(manager.references(&value), 1);
+    ASSERT_EQ(protect::get_protect(&value), memory_prot::kExecuteReadWrite);
+  }
+
+  ASSERT_EQ(manager.references(&value), 0);
+  ASSERT_EQ(protect::get_protect(&value), memory_prot::kReadWrite);
+}
+
+#if defined(MYWR_LINUX)
+TEST(ProtectTest, ShouldShareScopesBetweenThreads) {
+  std::size_t size = mywr::page_size();
+  auto*       page = static_cast<int*>(
+      mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ASSERT_NE(page, MAP_FAILED);
+
+  EXPECT_ISOLATED({
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([page, i] {
+        for (int j = 0; j < 2000; j++) {
+          protect::scoped_protect scope{
+              &page[i], sizeof(int), memory_prot::kReadWrite};
+          // Crashes if another thread restored the page under us.
+          page[i] = j;
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+
+    EXPECT_EQ(page[0], 1999);
+    EXPECT_EQ(protect::get_protect(page), memory_prot::kRead);
+  });
+  munmap(page, size);
+}
+
+TEST(ProtectTest, ShouldRestoreEveryPage) {
+  std::size_t size = mywr::page_size();
+  auto*       area = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                               size * 2,
+                                               PROT_READ,
+                                               MAP_PRIVATE | MAP_ANONYMOUS,
+                                               -1,
+                                               0));
+  ASSERT_NE(area, MAP_FAILED);
+  ASSERT_EQ(mprotect(area + size, size, PROT_READ | PROT_EXEC), 0);
+
+  {
+    protect::scoped_protect scope{
+        area + size - 1, 2, memory_prot::kExecuteReadWrite};
+    ASSERT_TRUE(scope.good());
+    ASSERT_EQ(protect::get_protect(area), memory_prot::kExecuteReadWrite);
+    ASSERT_EQ(protect::get_protect(area + size),
+              memory_prot::kExecuteReadWrite);
+  }
+
+  EXPECT_EQ(protect::get_protect(area), memory_prot::kRead);
+  EXPECT_EQ(protect::get_protect(area + size), memory_prot::kExecuteRead);
+  munmap(area, size * 2);
+}
+
+TEST(ProtectTest, ShouldProtectLargeAreas) {
+  std::size_t size = mywr::page_size() * 4096;
+  auto*       area = static_cast<mywr::byte_t*>(
+      mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ASSERT_NE(area, MAP_FAILED);
+
+  {
+    protect::scoped_protect scope{area, size, memory_prot::kReadWrite};
+    ASSERT_TRUE(scope.good());
+    ::memset(area, 0xCC, size);
+  }
+
+  EXPECT_EQ(area[size - 1], 0xCC);
+  EXPECT_EQ(protect::get_protect(area + size - 1), memory_prot::kRead);
+  munmap(area, size);
+}
+
+TEST(ProtectTest, ShouldShareLargeAndSmallScopes) {
+  constexpr std::size_t kPages = 256;
+
+  std::size_t size = mywr::page_size();
+  auto*       area = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                               size * kPages,
+                                               PROT_READ,
+                                               MAP_PRIVATE | MAP_ANONYMOUS,
+                                               -1,
+                                               0));
+  ASSERT_NE(area, MAP_FAILED);
+  ASSERT_EQ(mprotect(area + size * 200, size, PROT_READ | PROT_EXEC), 0);
+
+  auto& manager = protect::page_manager::instance();
+  auto  small   = std::make_unique<protect::scoped_protect>(
+      area + size * 10, 4, memory_prot::kReadWrite);
+  auto outlives = std::make_unique<protect::scoped_protect>(
+      area + size * 30, 4, memory_prot::kReadWrite);
+  ASSERT_TRUE(small->good());
+  ASSERT_TRUE(outlives->good());
+
+  {
+    protect::scoped_protect large{area, size * kPages, memory_prot::kReadWrite};
+    ASSERT_TRUE(large.good());
+    EXPECT_EQ(manager.references(area + size * 10), 2);
+    EXPECT_EQ(manager.references(area + size * 100), 1);
+
+    // Small scopes released inside the large one don't restore its pages.
+    small.reset();
+    {
+      protect::scoped_protect inner{
+          area + size * 20, 4, memory_prot::kReadWrite};
+      ASSERT_TRUE(inner.good());
+    }
+    EXPECT_EQ(protect::get_protect(area + size * 10), memory_prot::kReadWrite);
+    EXPECT_EQ(protect::get_protect(area + size * 20), memory_prot::kReadWrite);
+    EXPECT_EQ(protect::get_protect(area + size * 200), memory_prot::kReadWrite);
+    area[size * 10] = 1;
+    area[size * 20] = 2;
+  }
+
+  // The large scope doesn't restore the page still held by the small one.
+  EXPECT_EQ(protect::get_protect(area + size * 30), memory_prot::kReadWrite);
+  area[size * 30] = 3;
+  outlives.reset();
+
+  // Every region gets its own original protection back.
+  EXPECT_EQ(protect::get_protect(area), memory_prot::kRead);
+  EXPECT_EQ(protect::get_protect(area + size * 30), memory_prot::kRead);
+  EXPECT_EQ(protect::get_protect(area + size * 200), memory_prot::kExecuteRead);
+  EXPECT_EQ(protect::get_protect(area + size * (kPages - 1)),
+            memory_prot::kRead);
+  EXPECT_EQ(manager.references(area + size * 10), 0);
+  munmap(area, size * kPages);
+}
+
+TEST(ProtectTest, ShouldShareLargeScopesBetweenThreads) {
+  constexpr std::size_t kPages = 128;
+
+  std::size_t size = mywr::page_size();
+  auto*       area = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                               size * kPages,
+                                               PROT_READ,
+                                               MAP_PRIVATE | MAP_ANONYMOUS,
+                                               -1,
+                                               0));
+  ASSERT_NE(area, MAP_FAILED);
+
+  EXPECT_ISOLATED({
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < 4; i++) {
+      threads.emplace_back([area, size, i] {
+        for (std::size_t j = 0; j < 500; j++) {
+          // Half of the threads hold the whole area, half single pages.
+          std::size_t page   = (i * 31 + j * 7) % kPages;
+          std::size_t length = i % 2 ? size * kPages : 1;
+          auto*       begin  = i % 2 ? area : area + size * page;
+
+          protect::scoped_protect scope{
+              begin, length, memory_prot::kReadWrite};
+          // Crashes if another thread restored the page under us.
+          area[size * page + i] = static_cast<mywr::byte_t>(j);
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+
+    for (std::size_t i = 0; i < kPages; i++) {
+      EXPECT_EQ(protect::get_protect(area + size * i), memory_prot::kRead)
+          << i;
+    }
+  });
+  munmap(area, size * kPages);
+}
+
+TEST(ProtectTest, ShouldHoldMorePagesThanTable) {
+  constexpr std::size_t kPages = 2048;
+
+  std::size_t size = mywr::page_size();
+  auto*       area = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                               size * kPages,
+                                               PROT_READ,
+                                               MAP_PRIVATE | MAP_ANONYMOUS,
+                                               -1,
+                                               0));
+  ASSERT_NE(area, MAP_FAILED);
+
+  {
+    std::vector<std::unique_ptr<protect::scoped_protect>> scopes;
+    for (std::size_t i = 0; i < kPages; i++) {
+      scopes.push_back(std::make_unique<protect::scoped_protect>(
+          area + size * i, 1, memory_prot::kReadWrite));
+      ASSERT_TRUE(scopes.back()->good()) << i;
+    }
+
+    for (std::size_t i = 0; i < kPages; i++)
+      area[size * i] = 0xCC;
+  }
+
+  for (std::size_t i = 0; i < kPages; i += 97)
+    EXPECT_EQ(protect::get_protect(area + size * i), memory_prot::kRead) << i;
+  munmap(area, size * kPages);
+}
+
+TEST(ProtectTest, ShouldQueryProtectionAfterFork) {
+  int value = 0;
+  ASSERT_EQ(protect::get_protect(&value), memory_prot::kReadWrite);
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    std::size_t size = mywr::page_size();
+    void*       page =
+        mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED)
+      _exit(1);
+
+    // The mapping exists only in the child.
+    if (protect::get_protect(page) != memory_prot::kRead)
+      _exit(2);
+
+    {
+      protect::scoped_protect scope{page, size, memory_prot::kReadWrite};
+      if (!scope.good() ||
+          protect::get_protect(page) != memory_prot::kReadWrite)
+        _exit(3);
+    }
+    _exit(protect::get_protect(page) == memory_prot::kRead ? 0 : 4);
+  }
+
+  int result = 0;
+  ASSERT_EQ(waitpid(child, &result, 0), child);
+  ASSERT_TRUE(WIFEXITED(result));
+  EXPECT_EQ(WEXITSTATUS(result), 0);
+}
+
+TEST(ProtectTest, ShouldDeferRestore) {
+  std::size_t size = mywr::page_size();
+  auto*       page = static_cast<int*>(
+      mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ASSERT_NE(page, MAP_FAILED);
+
+  protect::set_deferred_restore(true);
+  for (int i = 0; i < 100; i++) {
+    protect::scoped_protect scope{page, sizeof(int), memory_prot::kReadWrite};
+    ASSERT_TRUE(scope.good());
+    *page = i;
+  }
+
+  // Released, but stays writable until the end of the epoch.
+  EXPECT_EQ(protect::page_manager::instance().pending(), 1);
+  EXPECT_EQ(protect::get_protect(page), memory_prot::kReadWrite);
+
+  // Scopes of the pending page reuse it.
+  EXPECT_NO_SYSCALLS({
+    protect::scoped_protect scope{page, sizeof(int), memory_prot::kReadWrite};
+    ASSERT_TRUE(scope.good());
+    *page = 100;
+  });
+
+  EXPECT_EQ(protect::flush_epoch(), 1);
+  EXPECT_EQ(protect::get_protect(page), memory_prot::kRead);
+  EXPECT_EQ(protect::page_manager::instance().pending(), 0);
+
+  // The epoch older than the budget is flushed by the release.
+  protect::set_deferred_restore(true, std::chrono::microseconds{1});
+  { protect::scoped_protect scope{page, sizeof(int), memory_prot::kReadWrite}; }
+  std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  { protect::scoped_protect scope{page, sizeof(int), memory_prot::kReadWrite}; }
+  EXPECT_EQ(protect::get_protect(page), memory_prot::kRead);
+
+  protect::set_deferred_restore(false);
+  munmap(page, size);
+}
+
+TEST(ProtectTest, ShouldDeferRestoreOfLargeAreas) {
+  constexpr std::size_t kPages = 128;
+
+  std::size_t size = mywr::page_size() * kPages;
+  auto*       area = static_cast<mywr::byte_t*>(
+      mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ASSERT_NE(area, MAP_FAILED);
+
+  protect::set_deferred_restore(true);
+  for (int i = 0; i < 10; i++) {
+    protect::scoped_protect scope{area, size, memory_prot::kReadWrite};
+    ASSERT_TRUE(scope.good());
+    area[size - 1] = static_cast<mywr::byte_t>(i);
+  }
+
+  EXPECT_EQ(protect::page_manager::instance().pending(), kPages);
+  EXPECT_EQ(protect::get_protect(area), memory_prot::kReadWrite);
+
+  EXPECT_EQ(protect::flush_epoch(), kPages);
+  EXPECT_EQ(protect::get_protect(area), memory_prot::kRead);
+  EXPECT_EQ(protect::page_manager::instance().pending(), 0);
+
+  protect::set_deferred_restore(false);
+  munmap(area, size);
+}
+
+TEST(ProtectTest, ShouldKeepHugePages) {
+  constexpr std::size_t kHuge = 2 * 1024 * 1024;
+
+  auto* mapping = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                                  kHuge * 2,
+                                                  PROT_READ | PROT_WRITE,
+                                                  MAP_PRIVATE | MAP_ANONYMOUS,
+                                                  -1,
+                                                  0));
+  ASSERT_NE(mapping, MAP_FAILED);
+
+  auto* huge = reinterpret_cast<mywr::byte_t*>(
+      (reinterpret_cast<std::uintptr_t>(mapping) + kHuge - 1) & ~(kHuge - 1));
+  madvise(huge, kHuge, MADV_HUGEPAGE);
+  huge[0] = 1;
+
+  mywr::procfs::smaps_region region{};
+  if (!mywr::procfs::query_smaps(reinterpret_cast<std::uintptr_t>(huge),
+                                 region) ||
+      region.anon_huge_pages == 0 ||
+      mywr::procfs::transparent_huge_page_size() != kHuge) {
+    munmap(mapping, kHuge * 2);
+    GTEST_SKIP() << "transparent huge pages are not available";
+  }
+
+  auto split = protect::estimate_split(huge + 4096, 4);
+  EXPECT_EQ(split.pages, 1);
+  EXPECT_EQ(split.page_size, kHuge);
+  EXPECT_EQ(split.begin, reinterpret_cast<mywr::address_t>(huge));
+  EXPECT_EQ(split.end, reinterpret_cast<mywr::address_t>(huge + kHuge));
+
+  protect::set_huge_page_mode(protect::huge_page_mode::kRefuse);
+  EXPECT_EQ(protect::set_protect(huge + 4096, 4, memory_prot::kRead),
+            memory_prot::kUnknown);
+
+  protect::set_huge_page_mode(protect::huge_page_mode::kAlign);
+  EXPECT_EQ(protect::set_protect(huge + 4096, 4, memory_prot::kRead),
+            memory_prot::kReadWrite);
+  EXPECT_EQ(protect::get_protect(huge + kHuge - 1), memory_prot::kRead);
+
+  // The whole huge page was changed, so it is still huge.
+  ASSERT_TRUE(mywr::procfs::query_smaps(
+      reinterpret_cast<std::uintptr_t>(huge), region));
+  EXPECT_NE(region.anon_huge_pages, 0);
+
+  protect::set_huge_page_mode(protect::huge_page_mode::kIgnore);
+  munmap(mapping, kHuge * 2);
+}
+
+class PkeyDomainTest
+    : public ::testing::TestWithParam<protect::pkey_domain::backend_type> {
+protected:
+  void SetUp() override {
+    m_size = mywr::page_size();
+    m_page = static_cast<int*>(mmap(
+        nullptr, m_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_NE(m_page, MAP_FAILED);
+  }
+
+  void TearDown() override {
+    munmap(m_page, m_size);
+  }
+
+  int*        m_page{};
+  std::size_t m_size{};
+};
+
+TEST_P(PkeyDomainTest, TogglesWritability) {
+  protect::pkey_domain domain{GetParam()};
+  if (GetParam() == protect::pkey_domain::kMprotect) {
+    ASSERT_EQ(domain.backend(), protect::pkey_domain::kMprotect);
+  }
+
+  ASSERT_TRUE(domain.tag(m_page, sizeof(int)));
+  EXPECT_FALSE(domain.writable());
+
+  {
+    protect::scoped_write write{domain};
+    ASSERT_TRUE(write.good());
+    EXPECT_TRUE(domain.writable());
+
+    {
+      protect::scoped_write nested{domain};
+      *m_page = 1;
+    }
+
+    EXPECT_TRUE(domain.writable());
+    *m_page = 2;
+  }
+
+  EXPECT_FALSE(domain.writable());
+  EXPECT_EQ(*m_page, 2);
+  EXPECT_DEATH(*m_page = 3, "");
+}
+
+TEST_P(PkeyDomainTest, SharesWritabilityBetweenThreads) {
+  protect::pkey_domain domain{GetParam()};
+  ASSERT_TRUE(domain.tag(m_page, sizeof(int) * 4));
+
+  EXPECT_ISOLATED({
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([this, &domain, i] {
+        for (int j = 0; j < 2000; j++) {
+          protect::scoped_write write{domain};
+          // Crashes if the region isn't writable yet.
+          m_page[i] = j;
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+
+    EXPECT_EQ(m_page[3], 1999);
+    EXPECT_FALSE(domain.writable());
+  });
+}
+
+TEST_P(PkeyDomainTest, RestoresProtection) {
+  {
+    protect::pkey_domain domain{GetParam()};
+    ASSERT_TRUE(domain.tag(m_page, sizeof(int)));
+  }
+
+  EXPECT_EQ(protect::get_protect(m_page), memory_prot::kRead);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         PkeyDomainTest,
+                         ::testing::Values(protect::pkey_domain::kPkey,
+                                           protect::pkey_domain::kMprotect));
+#endif
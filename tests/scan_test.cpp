@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+#include "syscall_budget.hpp"
+
+namespace scan = mywr::scan;
+
+#if defined(MYWR_LINUX)
+class ScanTest : public ::testing::Test {
+protected:
+  static constexpr std::size_t kPages = 16;
+
+  void SetUp() override {
+    m_page = mywr::page_size();
+    m_data = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                             m_page * kPages,
+                                             PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS,
+                                             -1,
+                                             0));
+    ASSERT_NE(m_data, MAP_FAILED);
+  }
+
+  void TearDown() override {
+    munmap(m_data, m_page * kPages);
+  }
+
+  mywr::address_range range() const {
+    return mywr::address_range::from_size(m_data, m_page * kPages);
+  }
+
+  std::size_t   m_page{};
+  mywr::byte_t* m_data{};
+};
+
+TEST_F(ScanTest, ShouldWalkResidentPages) {
+  // Pages 0-2 and 8 are resident, page 1 is a guard page.
+  for (std::size_t page : {0, 1, 2, 8})
+    std::memset(m_data + page * m_page, static_cast<int>(page + 1), m_page);
+  ASSERT_EQ(mprotect(m_data + m_page, m_page, PROT_NONE), 0);
+
+  scan::walk_options options;
+  options.chunk_size = m_page / 2;
+
+  std::vector<std::size_t> pages;
+  scan::walk(
+      range(),
+      [&](const scan::chunk& chunk) {
+        EXPECT_LE(chunk.size, options.chunk_size);
+
+        std::size_t page = (chunk.address - range().begin()) / m_page;
+        EXPECT_EQ(std::count(chunk.begin(), chunk.end(), page + 1),
+                  static_cast<std::ptrdiff_t>(chunk.size));
+        pages.push_back(page);
+      },
+      options);
+
+  EXPECT_EQ(pages, (std::vector<std::size_t>{0, 0, 2, 2, 8, 8}));
+}
+
+TEST_F(ScanTest, ShouldWalkEveryPageWithoutSkipping) {
+  scan::walk_options options;
+  options.skip_non_resident = false;
+
+  std::size_t size = 0;
+  scan::walk(
+      range(), [&](const scan::chunk& chunk) { size += chunk.size; }, options);
+
+  EXPECT_EQ(size, m_page * kPages);
+}
+
+TEST_F(ScanTest, ShouldQueryResidencyByWindows) {
+  std::memset(m_data, 1, m_page * kPages);
+
+  mywr_test::syscall_counter traversal;
+  mywr::procfs::for_each_region([](const mywr::procfs::memory_region&) {},
+                                true);
+  std::uint64_t maps = traversal.count();
+
+  // One traversal of the maps and one `mincore` for all pages of the region.
+  std::size_t bytes = 0;
+  EXPECT_SYSCALLS_LE(maps + 1, scan::walk(range(), [&](const scan::chunk& c) {
+    bytes += c.size;
+  }));
+  EXPECT_EQ(bytes, m_page * kPages);
+}
+
+TEST_F(ScanTest, ShouldStopWalking) {
+  std::memset(m_data, 1, m_page * kPages);
+
+  std::size_t chunks = 0;
+  scan::walk(range(), [&](const scan::chunk&) { return ++chunks < 2; });
+
+  EXPECT_EQ(chunks, 2u);
+}
+
+TEST_F(ScanTest, ShouldFindPatternsInProcess) {
+  static const char kPattern[] = "mywr-scan-pattern";
+  std::memcpy(m_data + m_page * 3 + 7, kPattern, sizeof(kPattern));
+
+  std::vector<mywr::address_t> found;
+  scan::walk([&](const scan::chunk& chunk) {
+    auto* it = chunk.begin();
+    while ((it = std::search(
+                it, chunk.end(), kPattern, kPattern + sizeof(kPattern))) !=
+           chunk.end()) {
+      found.push_back(chunk.address + (it - chunk.begin()));
+      it++;
+    }
+  });
+
+  auto expected = reinterpret_cast<mywr::address_t>(m_data + m_page * 3 + 7);
+  EXPECT_NE(std::find(found.begin(), found.end(), expected), found.end());
+}
+#endif
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+
+namespace stats = mywr::stats;
+
+using mywr::protect::memory_prot;
+
+class StatsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    if (!stats::enabled())
+      GTEST_SKIP() << "MYWR_FEATURE_STATS is not defined";
+
+    stats::reset();
+  }
+};
+
+TEST_F(StatsTest, CountsProtectionChanges) {
+  int value = 0;
+
+  mywr::protect::set_protect(&value, sizeof(value), memory_prot::kReadWrite);
+  mywr::protect::set_protect(&value, sizeof(value), memory_prot::kReadWrite);
+
+  auto counters = stats::snapshot();
+  EXPECT_EQ(counters.calls[stats::kSetProtect], 2);
+  EXPECT_GT(counters.nanoseconds[stats::kSetProtect], 0);
+  EXPECT_GE(counters.calls[stats::kSyscall], 2);
+}
+
+TEST_F(StatsTest, CountsMapsParsing) {
+  std::vector<mywr::procfs::memory_region> regions;
+  mywr::procfs::parse_maps(regions);
+
+  auto counters = stats::snapshot();
+  EXPECT_EQ(counters.calls[stats::kParseMaps], 1);
+  EXPECT_EQ(counters.calls[stats::kSetProtect], 0);
+}
+
+TEST_F(StatsTest, AggregatesThreads) {
+  std::thread worker{[] {
+    for (int i = 0; i < 10; i++)
+      stats::count(stats::kFlush);
+  }};
+  worker.join();
+
+  // The exited thread is still accounted.
+  stats::count(stats::kFlush);
+  EXPECT_EQ(stats::snapshot().calls[stats::kFlush], 11);
+
+  stats::reset();
+  EXPECT_EQ(stats::snapshot().calls[stats::kFlush], 0);
+}
@@ -0,0 +1,72 @@
+/*********************************************************************
+ * @file   syscall_budget.hpp
+ * @brief  Assertions on the number of system calls made by the library.
+ *
+ * @details
+ * Built on the `kSyscall` instrumentation counter, so it counts the system
+ * calls of all library modules (`mprotect`, `pread`, `ioctl`, ...) issued
+ * by any thread, without `ptrace` or `seccomp`. Requires the tests to be
+ * built with `MYWR_FEATURE_STATS`, otherwise nothing is counted and every
+ * budget holds.
+ *
+ * @code{.cpp}
+ * EXPECT_SYSCALLS_LE(1, mywr::protect::get_protect(&value));
+ * EXPECT_SYSCALLS_LE(0, {
+ *   auto first  = view.load();
+ *   auto second = view.load();
+ * });
+ * @endcode
+ *
+ * @author themusaigen
+ * @date   October 2026
+ * @copyright MIT License.
+ *********************************************************************/
+#ifndef MYWR_TESTS_SYSCALL_BUDGET_HPP_
+#define MYWR_TESTS_SYSCALL_BUDGET_HPP_
+
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+
+namespace mywr_test {
+/**
+ * @brief Counts system calls made by the library since construction.
+ */
+class syscall_counter {
+public:
+  syscall_counter()
+      : m_begin(calls()) {}
+
+  /**
+   * @brief Returns the number of system calls made since construction.
+   */
+  std::uint64_t count() const {
+    return calls() - m_begin;
+  }
+
+private:
+  static std::uint64_t calls() {
+    return mywr::stats::snapshot().calls[mywr::stats::kSyscall];
+  }
+
+  std::uint64_t m_begin;
+};
+} // namespace mywr_test
+
+/**
+ * @brief Expects the statements to make at most `limit` system calls.
+ */
+#define EXPECT_SYSCALLS_LE(limit, ...)                                         \
+  do {                                                                         \
+    ::mywr_test::syscall_counter mywr_syscalls;                                \
+    __VA_ARGS__;                                                               \
+    EXPECT_LE(mywr_syscalls.count(), static_cast<std::uint64_t>(limit))        \
+        << "system calls made by: " #__VA_ARGS__;                              \
+  } while (false)
+
+/**
+ * @brief Expects the statements to make no system calls.
+ */
+#define EXPECT_NO_SYSCALLS(...) EXPECT_SYSCALLS_LE(0, __VA_ARGS__)
+
+#endif // !MYWR_TESTS_SYSCALL_BUDGET_HPP_
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+
+namespace trace = mywr::trace;
+
+using mywr::protect::memory_prot;
+
+/**
+ * @brief Returns the number of occurrences of the pattern in the text.
+ */
+static std::size_t occurrences(const std::string& text,
+                               const std::string& pattern) {
+  std::size_t count = 0;
+  for (auto at = text.find(pattern); at != std::string::npos;
+       at      = text.find(pattern, at + pattern.size()))
+    count++;
+  return count;
+}
+
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    if (!trace::enabled())
+      GTEST_SKIP() << "MYWR_FEATURE_TRACE is not defined";
+
+    trace::clear();
+  }
+};
+
+TEST_F(TraceTest, RecordsOperations) {
+  std::vector<mywr::byte_t> buffer(4096);
+  mywr::llmo::fill(buffer.data(), 0x90, buffer.size());
+
+  int value = 0;
+  mywr::protect::set_protect(&value, sizeof(value), memory_prot::kReadWrite);
+
+  std::vector<mywr::procfs::memory_region> regions;
+  mywr::procfs::parse_maps(regions);
+
+  std::string json = trace::dump();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+  EXPECT_NE(json.find("\"name\":\"llmo::fill\""), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"size\":4096}"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"protect::set_protect\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"procfs::parse_maps\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+}
+
+TEST_F(TraceTest, KeepsLastEvents) {
+  for (std::size_t i = 0; i < trace::kCapacity + 10; i++) {
+    MYWR_TRACE_SCOPE("test::event", i + 1);
+  }
+
+  std::string json = trace::dump();
+  EXPECT_EQ(occurrences(json, "\"name\":\"test::event\""), trace::kCapacity);
+  EXPECT_EQ(json.find("\"args\":{\"size\":10}"), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"size\":11}"), std::string::npos);
+}
+
+TEST_F(TraceTest, KeepsEventsOfExitedThreads) {
+  std::thread worker{[] {
+    MYWR_TRACE_SCOPE("test::worker", 0);
+  }};
+  worker.join();
+
+  EXPECT_EQ(occurrences(trace::dump(), "\"name\":\"test::worker\""), 1);
+
+  trace::clear();
+  EXPECT_EQ(occurrences(trace::dump(), "\"name\":\"test::worker\""), 0);
+}
+
+TEST_F(TraceTest, WritesFiles) {
+  {
+    MYWR_TRACE_SCOPE("test::file", 0);
+  }
+
+  auto path = std::filesystem::temp_directory_path() / "mywr_trace_test.json";
+  ASSERT_TRUE(trace::dump(path));
+
+  std::ifstream file(path);
+  std::string   json{std::istreambuf_iterator<char>(file), {}};
+  EXPECT_NE(json.find("\"name\":\"test::file\""), std::string::npos);
+
+  file.close();
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include "mywr/mywr.hpp"
+
+#if defined(MYWR_LINUX)
+using namespace mywr::watch;
+
+class WatchTest : public ::testing::TestWithParam<region::backend_type> {
+protected:
+  void SetUp() override {
+    m_size = mywr::page_size() * 2;
+    m_page = static_cast<int*>(mmap(nullptr,
+                                    m_size,
+                                    PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS,
+                                    -1,
+                                    0));
+    ASSERT_NE(m_page, MAP_FAILED);
+  }
+
+  void TearDown() override {
+    munmap(m_page, m_size);
+  }
+
+  int*        m_page{};
+  std::size_t m_size{};
+};
+
+TEST(WatchRingBufferTest, HandlesOverflow) {
+  ring_buffer<int> buffer{2};
+
+  EXPECT_TRUE(buffer.push(1));
+  EXPECT_TRUE(buffer.push(2));
+  EXPECT_FALSE(buffer.push(3));
+  EXPECT_EQ(buffer.dropped(), 1);
+
+  int value{};
+  EXPECT_TRUE(buffer.pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(buffer.pop(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_FALSE(buffer.pop(value));
+}
+
+TEST_P(WatchTest, RecordsWrites) {
+  region watcher{m_page, sizeof(int), 16, GetParam()};
+  if (!watcher.good())
+    GTEST_SKIP() << "backend is unavailable";
+
+  write_record record{};
+  EXPECT_FALSE(watcher.pop(record));
+
+  *m_page = 123;
+
+  ASSERT_TRUE(watcher.pop(record));
+  EXPECT_EQ(*m_page, 123);
+  EXPECT_LE(record.address, reinterpret_cast<mywr::address_t>(m_page));
+  if (watcher.backend() == region::kMprotect) {
+    EXPECT_EQ(record.address, reinterpret_cast<mywr::address_t>(m_page));
+    EXPECT_NE(record.ip, 0);
+  }
+
+  // Page is writable again until rearm.
+  *m_page = 124;
+  EXPECT_FALSE(watcher.pop(record));
+
+  ASSERT_TRUE(watcher.rearm());
+  *m_page = 125;
+  EXPECT_TRUE(watcher.pop(record));
+}
+
+TEST_P(WatchTest, IgnoresOtherPages) {
+  region watcher{m_page, sizeof(int), 16, GetParam()};
+  if (!watcher.good())
+    GTEST_SKIP() << "backend is unavailable";
+
+  // The second page isn't watched.
+  m_page[mywr::page_size() / sizeof(int)] = 1;
+
+  write_record record{};
+  EXPECT_FALSE(watcher.pop(record));
+}
+
+TEST_P(WatchTest, RestoresProtection) {
+  {
+    region watcher{m_page, sizeof(int), 16, GetParam()};
+  }
+
+  EXPECT_EQ(mywr::protect::get_protect(m_page),
+            mywr::protect::memory_prot::kReadWrite);
+  *m_page = 1;
+}
+
+TEST_P(WatchTest, RejectsMixedProtection) {
+  if (GetParam() != region::kMprotect)
+    GTEST_SKIP() << "only the mprotect backend changes protection";
+
+  auto* second = reinterpret_cast<mywr::byte_t*>(m_page) + mywr::page_size();
+  ASSERT_EQ(mprotect(second, mywr::page_size(), PROT_READ), 0);
+
+  {
+    // Restoring one protection would make the second page writable.
+    region watcher{m_page, m_size, 16, GetParam()};
+    EXPECT_FALSE(watcher.good());
+  }
+
+  EXPECT_EQ(mywr::protect::get_protect(m_page),
+            mywr::protect::memory_prot::kReadWrite);
+  EXPECT_EQ(mywr::protect::get_protect(second),
+            mywr::protect::memory_prot::kRead);
+}
+
+TEST(AccessSamplerTest, BuildsHeatMap) {
+  const std::size_t page_size = mywr::page_size();
+  const std::size_t size      = page_size * 8;
+
+  auto* pages = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                                size,
+                                                PROT_READ | PROT_WRITE,
+                                                MAP_PRIVATE | MAP_ANONYMOUS,
+                                                -1,
+                                                0));
+  ASSERT_NE(pages, MAP_FAILED);
+
+  // Mixed protections must be restored precisely.
+  ASSERT_EQ(mprotect(pages + page_size * 6, page_size, PROT_READ), 0);
+
+  {
+    access_sampler sampler{pages, size, 2};
+    ASSERT_TRUE(sampler.good());
+
+    pages[0]             = 1;
+    pages[page_size * 4] = 2;
+
+    auto heat_map = sampler.heat_map();
+    ASSERT_EQ(heat_map.size(), 4);
+    EXPECT_EQ(sampler.touched(), 2);
+
+    EXPECT_TRUE(heat_map[0].touched);
+    EXPECT_FALSE(heat_map[1].touched);
+    EXPECT_TRUE(heat_map[2].touched);
+    EXPECT_FALSE(heat_map[3].touched);
+
+    EXPECT_EQ(heat_map[2].page,
+              reinterpret_cast<mywr::address_t>(pages + page_size * 4));
+    EXPECT_EQ(heat_map[2].address, heat_map[2].page);
+    EXPECT_NE(heat_map[2].ip, 0);
+    EXPECT_GE(heat_map[2].timestamp, heat_map[0].timestamp);
+  }
+
+  using mywr::protect::memory_prot;
+  EXPECT_EQ(mywr::protect::get_protect(pages + page_size * 2),
+            memory_prot::kReadWrite);
+  EXPECT_EQ(mywr::protect::get_protect(pages + page_size * 6),
+            memory_prot::kRead);
+  EXPECT_EQ(pages[page_size * 4], 2);
+
+  munmap(pages, size);
+}
+
+TEST(AccessSamplerTest, SkipsInaccessiblePages) {
+  const std::size_t page_size = mywr::page_size();
+  const std::size_t size      = page_size * 2;
+
+  auto* pages = static_cast<mywr::byte_t*>(mmap(nullptr,
+                                                size,
+                                                PROT_READ | PROT_WRITE,
+                                                MAP_PRIVATE | MAP_ANONYMOUS,
+                                                -1,
+                                                0));
+  ASSERT_NE(pages, MAP_FAILED);
+  ASSERT_EQ(mprotect(pages + page_size, page_size, PROT_NONE), 0);
+
+  {
+    access_sampler sampler{pages, size};
+    ASSERT_TRUE(sampler.good());
+
+    pages[0] = 1;
+    // Not sampled, so the access reaches the default handler.
+    EXPECT_DEATH(pages[page_size] = 1, "");
+
+    auto heat_map = sampler.heat_map();
+    ASSERT_EQ(heat_map.size(), 2);
+    EXPECT_TRUE(heat_map[0].touched);
+    EXPECT_FALSE(heat_map[1].touched);
+  }
+
+  using mywr::protect::memory_prot;
+  EXPECT_EQ(mywr::protect::get_protect(pages), memory_prot::kReadWrite);
+  EXPECT_EQ(mywr::protect::get_protect(pages + page_size),
+            memory_prot::kNoAccess);
+
+  munmap(pages, size);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         WatchTest,
+                         ::testing::Values(region::kUserfaultfd,
+                                           region::kMprotect));
+#endif